@@ -6,9 +6,18 @@
 #endif
 #include <cstddef>
 #include <map>
+#include <set>
 #include <unordered_set>
 
 namespace infini {
+  // Placement policy used when several free blocks can hold a request.
+  enum class AllocPolicy
+  {
+    FirstFit, // lowest offset that fits, linear in the number of free blocks
+    BestFit,  // smallest block that fits, O(log n)
+    WorstFit, // largest block, O(log n)
+  };
+
   class Allocator
   {
   private:
@@ -24,10 +33,15 @@ namespace infini {
 
     void *ptr;
 
+    AllocPolicy policy;
+
+    // free blocks indexed by offset (for coalescing) and by size (for
+    // best/worst-fit lookup); both always hold the same blocks
     std::map<size_t, size_t> freeBlocks;
+    std::set<std::pair<size_t, size_t>> freeBlocksBySize; // (size, offset)
 
   public:
-    Allocator(Runtime runtime);
+    Allocator(Runtime runtime, AllocPolicy policy = AllocPolicy::BestFit);
 
     virtual ~Allocator();
 
@@ -43,15 +57,32 @@ namespace infini {
     //     size: size of memory block to be freed
     void free(size_t addr, size_t size);
 
+    // function: release the memory and forget every simulated allocation,
+    // so that the allocator can be used to plan again
+    void reset();
+
     // function: perform actual memory allocation
     // return: pointer to the head address of the allocated memory
     void *getPtr();
 
     void info();
 
+    // function: size of the arena needed by the simulated allocations so far
+    size_t getPeak() const { return peak; }
+
+    AllocPolicy getPolicy() const { return policy; }
+
   private:
     // function: memory alignment, rouned up
     // return: size of the aligned memory block
     size_t getAlignedSize(size_t size);
+
+    // function: pick a free block of at least `size` bytes by the policy
+    // return: iterator into freeBlocks, or freeBlocks.end() if none fits
+    std::map<size_t, size_t>::iterator findFreeBlock(size_t size);
+
+    void insertFreeBlock(size_t addr, size_t size);
+
+    void eraseFreeBlock(std::map<size_t, size_t>::iterator it);
   };
 }
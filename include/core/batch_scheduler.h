@@ -0,0 +1,96 @@
+#pragma once
+#include "core/compiled_model.h"
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <future>
+#include <mutex>
+#include <thread>
+
+namespace infini
+{
+    /**
+     * @brief Dynamic batching for serving many single-sample requests.
+     * Requests are collected until `maxBatch` of them are waiting or the
+     * oldest has waited `maxDelay`, then their inputs are stacked along the
+     * first dimension, the batch runs once, and each caller gets its slice
+     * of the outputs back.
+     *
+     * The network is given as a function building its graph for a batch
+     * size. Tensors are matched to the reference graph by their position in
+     * getTensors(), so the builder must add them in the same order for every
+     * size; each weight must also keep its reference's shape and type, which
+     * is checked. Each batch size seen is built, shape-inferred and planned
+     * once, and its compiled model and execution context are kept for the
+     * next batch of that size. All of them read the weights of the batch-1
+     * reference graph; the graphs built are never allocated, their contexts
+     * holding just the activations.
+     */
+    class BatchSchedulerObj
+    {
+    public:
+        using GraphBuilder = std::function<Graph(int batch)>;
+
+    private:
+        // a request's own input and output buffers, one per graph input and
+        // output
+        struct Request
+        {
+            vector<const void *> inputs;
+            vector<void *> outputs;
+            std::promise<void> done;
+        };
+        struct Batch
+        {
+            CompiledModel model;
+            ExecutionContext context;
+            TensorVec inputs, outputs;
+        };
+
+        GraphBuilder build;
+        Graph reference;
+        // positions of the request inputs in GraphObj::getTensors()
+        vector<size_t> inputIndex;
+        size_t maxBatch;
+        std::chrono::microseconds maxDelay;
+        std::map<size_t, Batch> batches;
+
+        std::mutex mutex;
+        std::condition_variable requestQueued;
+        std::deque<std::pair<std::chrono::steady_clock::time_point, Request>>
+            queue;
+        bool stopping = false;
+        std::thread dispatcher;
+
+        void loop();
+        Batch &getBatch(size_t size);
+        void runBatch(vector<Request> &requests);
+
+    public:
+        /**
+         * @param reference The graph for a batch of one, after dataMalloc
+         * and with its weights filled in.
+         * @param inputs The inputs of `reference` that requests provide; the
+         * other graph inputs are weights. Request inputs and all graph
+         * outputs have the batch as their first dimension.
+         */
+        BatchSchedulerObj(const GraphBuilder &build, const Graph &reference,
+                          const TensorVec &inputs, size_t maxBatch,
+                          std::chrono::microseconds maxDelay);
+        // Runs the requests still queued, then stops.
+        ~BatchSchedulerObj();
+        BatchSchedulerObj(const BatchSchedulerObj &) = delete;
+        BatchSchedulerObj &operator=(const BatchSchedulerObj &) = delete;
+
+        /**
+         * @brief Queues one sample: `inputData[i]` holds request input i and
+         * `outputData[i]` receives graph output i, both for a batch of one.
+         * The future becomes ready once the outputs are written, and
+         * rethrows any error of the batch. The buffers must stay valid until
+         * then.
+         */
+        std::future<void> submit(const vector<const void *> &inputData,
+                                 const vector<void *> &outputData);
+    };
+
+} // namespace infini
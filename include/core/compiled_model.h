@@ -0,0 +1,82 @@
+#pragma once
+#include "core/execution_plan.h"
+
+namespace infini
+{
+    class CompiledModelObj;
+    class ExecutionContextObj;
+    using CompiledModel = Ref<CompiledModelObj>;
+    using ExecutionContext = Ref<ExecutionContextObj>;
+
+    /**
+     * @brief The read-only half of a graph split for concurrent serving: its
+     * topology, kernel choices and weights. Everything a run writes, i.e.
+     * the request inputs and the tensors the graph computes, lives instead
+     * in an ExecutionContext, in an arena laid out by a memory plan of those
+     * tensors alone. Any number of contexts share the model's weights, and
+     * different contexts can run at the same time.
+     *
+     * Build it once the weights are filled in (after dataMalloc, unless
+     * they are bound elsewhere) and tuned, and leave the graph unchanged
+     * while contexts of it exist.
+     */
+    class CompiledModelObj
+    {
+    private:
+        Graph graph;
+        TensorVec inputs;
+        DataBinding weights;
+        // offsets of the tensors living in the contexts
+        unordered_map<TensorObj *, size_t> offsets;
+        size_t arenaSize = 0;
+
+    public:
+        /**
+         * @param inputs The graph inputs that change from run to run; the
+         * other graph inputs are weights.
+         * @param weights Where the weights live. Defaults to the graph's own
+         * blobs; another binding lets models of the same network built for
+         * different shapes share one copy.
+         */
+        CompiledModelObj(const Graph &graph, const TensorVec &inputs,
+                         const DataBinding &weights = tensorData);
+
+        const Graph &getGraph() const { return graph; }
+        const TensorVec &getInputs() const { return inputs; }
+        // Bytes of the arena of every context.
+        size_t getArenaSize() const { return arenaSize; }
+        // Where `tensor` lives in a context whose arena is `arena`.
+        void *getData(const Tensor &tensor, void *arena) const;
+    };
+
+    /**
+     * @brief The activations of one run of a CompiledModel: an arena for
+     * the request inputs and computed tensors, and an execution plan bound
+     * to it. A context runs one request at a time; use one per thread.
+     */
+    class ExecutionContextObj
+    {
+    private:
+        CompiledModel model;
+        void *arena;
+        ExecutionPlan plan;
+
+    public:
+        explicit ExecutionContextObj(const CompiledModel &model);
+        ~ExecutionContextObj();
+        ExecutionContextObj(const ExecutionContextObj &) = delete;
+        ExecutionContextObj &operator=(const ExecutionContextObj &) = delete;
+
+        // Data of `tensor` in this context, to fill inputs and read outputs.
+        void *getData(const Tensor &tensor) const
+        {
+            return model->getData(tensor, arena);
+        }
+        // Runs the model on this context's inputs, on the calling thread and
+        // the runtime's threads.
+        void run() const;
+
+        const CompiledModel &getModel() const { return model; }
+    };
+
+} // namespace infini
@@ -1,6 +1,7 @@
 #pragma once
 #include "core/common.h"
 #include <cstdint>
+#include <iterator>
 
 namespace infini {
 
@@ -48,6 +49,9 @@ class DataType {
         "Float16",     "Double",  "UInt32", "UInt64", "PlaceHolder",
         "PlaceHolder", "BFloat16"};
 
+    // number of data type indices, including the placeholders
+    static constexpr size_t count = std::size(names);
+
     static constexpr int cpuType[]{-1, 0, 2, 3, 4, 5,  6,  7, -1,
                                    3,  4, 9, 1, 8, -1, -1, 4};
 
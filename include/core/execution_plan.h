@@ -0,0 +1,66 @@
+#pragma once
+#include "core/graph.h"
+#include "core/kernel.h"
+#include "utils/thread_pool.h"
+#include <limits>
+
+namespace infini
+{
+    /**
+     * @brief A graph compiled for repeated runs: one step per operator, in
+     * the graph's order, holding its kernel and the state the kernel
+     * prepared (raw data pointers, sizes and strides). Running the plan is a
+     * loop over the steps without registry lookups, casts or shape walks.
+     *
+     * The plan captures the graph's memory layout and kernel choices, so
+     * build it after dataMalloc (and tune), and again after any change.
+     *
+     * Steps also record which steps consume their outputs, so that
+     * independent branches can run concurrently on a thread pool.
+     */
+    class ExecutionPlanObj
+    {
+    private:
+        struct Step
+        {
+            const Kernel *kernel;
+            std::unique_ptr<KernelState> state;
+            // steps reading an output of this one, and the number of steps
+            // whose outputs this one reads
+            vector<size_t> successors;
+            size_t nPredecessors = 0;
+        };
+
+        // keeps the graph, and the memory the steps point into, alive;
+        // unset in the plan a graph caches for itself
+        Graph graph;
+        Runtime runtime;
+        vector<Step> steps;
+
+        friend class GraphObj;
+        ExecutionPlanObj(GraphObj &graph, const DataBinding &data);
+
+    public:
+        /**
+         * @param data Where the data of each tensor lives. Defaults to the
+         * blobs GraphObj::dataMalloc gave the tensors.
+         */
+        explicit ExecutionPlanObj(const Graph &graph,
+                                  const DataBinding &data = tensorData);
+
+        // Runs the steps one after another on the calling thread.
+        void run() const;
+
+        /**
+         * @brief Runs every step as soon as the steps it depends on are done,
+         * at most `maxConcurrent` at a time, on the workers of `pool` and the
+         * calling thread. The kernels' parallel loops share the same pool,
+         * so idle threads help whichever step has work left.
+         */
+        void run(ThreadPool &pool,
+                 size_t maxConcurrent = std::numeric_limits<size_t>::max()) const;
+
+        size_t size() const { return steps.size(); }
+    };
+
+} // namespace infini
@@ -1,62 +1,124 @@
 #pragma once
 #include "core/allocator.h"
+#include "core/memory_planner.h"
 #include "core/operator.h"
+#include "core/quantization.h"
 #include "core/tensor.h"
 #include <algorithm>
 #include <cstdint>
+#include <limits>
 
 namespace infini
 {
 
     class TransposeObj;
 
-    class GraphObj : public Object
+    class GraphObj : public Object,
+                     public std::enable_shared_from_this<GraphObj>
     {
     protected:
         Runtime runtime;
-        TensorVec tensors;
-        OpVec ops;
+        // removed tensors and operators are erased from these lazily, see
+        // compact()
+        mutable TensorVec tensors;
+        mutable OpVec ops;
         Allocator allocator;
+        // tensors by fuid and operators by guid
+        unordered_map<UidBaseType, Tensor> tensorIndex;
+        unordered_map<UidBaseType, Operator> opIndex;
 
     public:
-        explicit GraphObj(Runtime runtime)
-            : runtime(runtime), allocator(runtime), sorted(false){};
+        explicit GraphObj(Runtime runtime,
+                          AllocPolicy policy = AllocPolicy::BestFit)
+            : runtime(runtime), allocator(runtime, policy), sorted(false){};
         string toString() const override;
         Runtime getRuntime() const { return runtime; }
 
         Tensor addTensor(Shape dim, DataType dtype = DataType::Float32);
         Tensor addTensor(const Tensor &tensor);
         TensorVec addTensor(const TensorVec &tensors);
-        void removeOperator(Operator op)
+        /**
+         * @brief Remove an operator or a tensor in amortized O(1): it leaves
+         * the indices at once and getOperators()/getTensors() at the next
+         * call, keeping the order of the others.
+         */
+        void removeOperator(const Operator &op);
+        void removeTensor(const Tensor &tensor);
+
+        const TensorVec &getTensors() const
         {
-            auto it = std::find(ops.begin(), ops.end(), op);
-            if (it != ops.end())
-                ops.erase(it);
+            compact();
+            return tensors;
         }
-
-        void removeTensor(Tensor tensor)
+        const OpVec &getOperators() const
         {
-            auto it = std::find(tensors.begin(), tensors.end(), tensor);
-            if (it != tensors.end())
-                tensors.erase(it);
+            compact();
+            return ops;
         }
-
-        const TensorVec &getTensors() const { return tensors; }
-        const OpVec &getOperators() const { return ops; }
         Tensor getTensor(int) const;
+        bool hasOperator(const Operator &op) const;
+        bool hasTensor(const Tensor &tensor) const;
+        // bytes of the memory pool planned by dataMalloc
+        size_t getPeakMemory() const { return allocator.getPeak(); }
 
         /**
          * @brief Sort the nodes in topological order.
          * It returns true if the sorting is successful.
          * Otherwise false is returned, means that there are rings in the graph,
-         * so the topological sorting fails.
+         * so the topological sorting fails. Ops that are already in order
+         * keep their positions.
          */
         bool topo_sort();
 
         void optimize();
 
+        /**
+         * @brief Post-training quantization. Runs the graph on the calibration
+         * samples, each computed tensor in a buffer of its own, to record
+         * the range of every Float32 tensor, rewrites each
+         * MatMul whose B is a weight into QuantizeLinear -> QuantizedMatMul ->
+         * DequantizeLinear, folds back-to-back DequantizeLinear/QuantizeLinear
+         * pairs, reallocates memory and reports the SQNR of the graph outputs
+         * against the float results. dataMalloc must have been called and the
+         * weights filled in.
+         */
+        QuantizationReport quantize(const vector<CalibrationSample> &calibration);
+
+        /**
+         * @brief Automatic mixed precision. Runs MatMul and arithmetic
+         * elementwise ops, and the exact ops (Relu, Clip, Transpose, Concat)
+         * fed by their results, in `dtype` (Float16 or BFloat16). Casts are
+         * inserted only where Float32 activations enter or leave these
+         * regions, so graph inputs and outputs stay Float32. Graph inputs not
+         * in `inputs` are weights: the ones read in `dtype` are converted
+         * once, here, rather than cast on every run. dataMalloc must have
+         * been called and the weights filled in; memory is reallocated, so
+         * `inputs` are to be filled afterwards.
+         */
+        void mixedPrecision(const TensorVec &inputs,
+                            DataType dtype = DataType::Float16);
+
         void shape_infer();
 
+        /**
+         * @brief Plans the memory pool for the current shapes without
+         * allocating anything: the offsets are one per tensor, in the order
+         * of getTensors(). dataMalloc allocates and binds this plan.
+         * Tensors in `external` live elsewhere, such as weights shared with
+         * other copies of the network: they take no space and get offset 0.
+         */
+        MemoryPlan planMemory(const TensorVec &external = {});
+
+        /**
+         * @brief Plans the memory pool once for shapes holding the symbolic
+         * dimension `symbol`, for any value n it may take: tensor i lives at
+         * offsets[i] + scales[i] * n. Tensor sizes must be linear in n, and
+         * no other symbol may appear. Tensors in `external` take no space,
+         * as for planMemory.
+         */
+        ParametricMemoryPlan planParametricMemory(ShapeElem symbol,
+                                                  const TensorVec &external = {});
+
         void dataMalloc();
 
         /**
@@ -87,6 +149,7 @@ namespace infini
          */
         inline TensorVec getInputs() const
         {
+            compact();
             TensorVec ret;
             for (const auto &t : tensors)
                 if (!t->getSource())
@@ -99,6 +162,7 @@ namespace infini
          */
         inline TensorVec getOutputs() const
         {
+            compact();
             TensorVec ret;
             for (const auto &t : tensors)
                 if (t->getTargets().empty())
@@ -108,17 +172,61 @@ namespace infini
 
         bool checkValid() const;
 
+        /**
+         * @brief The plan run() executes, built on first use and kept until
+         * something it captured changes: dataMalloc, shape_infer, tune or an
+         * edit of the operators. Tensors given other blobs by hand need
+         * invalidateExecutionPlan().
+         */
+        const ExecutionPlanObj &getExecutionPlan();
+        void invalidateExecutionPlan() { executionPlan.reset(); }
+
     private:
+        // Buffers of the memory pool: tensor i lives in buffers[i], at
+        // offsets[i] inside it, or in none if it is external.
+        struct BufferLayout
+        {
+            static constexpr size_t none = std::numeric_limits<size_t>::max();
+            vector<TensorLifetime> lifetimes;
+            vector<size_t> buffers, offsets;
+        };
+
+        /**
+         * @brief Lifetimes of the buffers the memory plan places, with the
+         * tensors sized by `bytes` and those in `external` left out. Inputs
+         * of a Concat are laid inside its output where possible.
+         */
+        BufferLayout
+        layoutBuffers(const std::function<size_t(const Tensor &)> &bytes,
+                      const TensorVec &external);
+
         /**
          * @brief Add reverse connections and Op relationship in ctor.
          */
         void addOperatorAndConnect(const Operator &op);
 
+        /**
+         * @brief Erase the tensors and operators removed since the last call.
+         */
+        void compact() const;
+
+        /**
+         * @brief Rebuild the indices and all tensor and operator links from
+         * the inputs and outputs of the operators, after a pass edited them
+         * in place.
+         */
+        void reconnect();
+
         /**
          * @brief If the nodes is sorted in topological order.
          */
         bool sorted;
 
+        ExecutionPlan executionPlan;
+
+        mutable std::unordered_set<TensorObj *> removedTensors;
+        mutable std::unordered_set<OperatorObj *> removedOps;
+
         /**
          * @brief Check if transpose only swaps the last two dimensions.
          */
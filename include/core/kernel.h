@@ -3,15 +3,43 @@
 #include "core/operator.h"
 #include "core/tensor.h"
 #include "utils/operator_utils.h"
+#include <array>
 #include <functional>
+#include <memory>
 
 namespace infini
 {
 
     class RuntimeObj;
 
+    /**
+     * @brief What a kernel derives from its op ahead of time: raw data
+     * pointers, sizes and strides. Built once by Kernel::prepare when a graph
+     * is compiled into an ExecutionPlan and read by Kernel::run on every run.
+     */
+    struct KernelState
+    {
+        virtual ~KernelState() {}
+    };
+
+    // Resolves the data pointer of every tensor a prepared kernel touches.
+    using DataBinding = std::function<void *(const Tensor &)>;
+
+    // Binds tensors to the blobs GraphObj::dataMalloc gave them.
+    inline void *tensorData(const Tensor &tensor)
+    {
+        return tensor->getRawDataPtr<void *>();
+    }
+
     class Kernel
     {
+        // keeps the op so that the default run() can call compute()
+        struct OpState : KernelState
+        {
+            Operator op;
+            explicit OpState(Operator op) : op(std::move(op)) {}
+        };
+
     public:
         Kernel() {}
         virtual ~Kernel() {}
@@ -21,8 +49,39 @@ namespace infini
          */
         virtual void compute(const Operator &op,
                              const RuntimeObj *context) const = 0;
+
+        /**
+         * @brief Derives everything run() needs from the op, taking data
+         * pointers from `data`. The default keeps the op itself, so that
+         * run() falls back to compute() on the tensors' own data.
+         */
+        virtual std::unique_ptr<KernelState>
+        prepare(const Operator &op, const DataBinding &data) const
+        {
+            return std::make_unique<OpState>(op);
+        }
+
+        /**
+         * @brief Executes an op from the state prepare() built for it.
+         */
+        virtual void run(const KernelState &state,
+                         const RuntimeObj *context) const
+        {
+            compute(static_cast<const OpState &>(state).op, context);
+        }
     };
 
+    /**
+     * @brief Kernels by device, op type and data type. Each key has a default
+     * kernel, registered with REGISTER_KERNEL (or REGISTER_TYPED_KERNEL for a
+     * single data type), and any number of alternative implementations
+     * registered with REGISTER_KERNEL_CANDIDATE, which the autotuner
+     * (RuntimeObj::tune) can time against it.
+     *
+     * Keys index a dense table. Falling back from a data type without its own
+     * kernel to the untyped one is resolved at registration time, so a lookup
+     * is a single load.
+     */
     class KernelRegistry
     {
     public:
@@ -30,46 +89,107 @@ namespace infini
             tuple<Kernel *const, const string, const int>; // Kernel, name, ID
 
     private:
-        std::map<KernelAttrs, KernelRecord> kernels;
+        static constexpr size_t nDevices = size_t(Device::CPU) + 1;
+        static constexpr size_t nOpTypes = OpType::NumOpTypes;
+        static constexpr size_t nDTypes = DataType::count;
+        static constexpr size_t nKeys = nDevices * nOpTypes * nDTypes;
+
+        // the default kernel, if registered, comes first
+        std::array<vector<KernelRecord>, nKeys> kernels;
+        std::array<bool, nKeys> hasDefault{};
+        // records serving each key, nullptr if there is no kernel
+        std::array<const vector<KernelRecord> *, nKeys> dispatch{};
         int nKernels = 0;
 
+        static size_t index(const KernelAttrs &kernelAttrs)
+        {
+            const size_t device = size_t(kernelAttrs.device),
+                         dtype = kernelAttrs.dtype.getIndex();
+            IT_ASSERT(device < nDevices && kernelAttrs.opType < nOpTypes &&
+                      dtype < nDTypes);
+            return (device * nOpTypes + kernelAttrs.opType) * nDTypes + dtype;
+        }
+        // Points every data type of (device, opType) at its own records, or
+        // at the untyped ones if it has no default kernel.
+        void resolve(const KernelAttrs &kernelAttrs)
+        {
+            const size_t untyped =
+                index({kernelAttrs.device, kernelAttrs.opType});
+            for (size_t i = untyped; i < untyped + nDTypes; ++i)
+                dispatch[i] = hasDefault[i]         ? &kernels[i]
+                              : hasDefault[untyped] ? &kernels[untyped]
+                                                    : nullptr;
+        }
+
     public:
         ~KernelRegistry()
         {
-            for (auto &[k, v] : kernels)
-                delete std::get<0>(v);
+            for (auto &records : kernels)
+                for (auto &v : records)
+                    delete std::get<0>(v);
         }
         static KernelRegistry &getInstance()
         {
             static KernelRegistry instance;
             return instance;
         }
-        bool registerKernel(const KernelAttrs &key, Kernel *kernel, string name)
+        bool registerKernel(const KernelAttrs &key, Kernel *kernel, string name,
+                            bool candidate = false)
         {
-            IT_ASSERT(kernels.find(key) == kernels.end(),
-                      "Kernel already registered");
-            kernels.emplace(key, KernelRecord{kernel, name, ++nKernels});
+            const size_t i = index(key);
+            auto &records = kernels[i];
+            for (auto &record : records)
+                IT_ASSERT(std::get<1>(record) != name,
+                          "Kernel already registered");
+            if (candidate)
+            {
+                records.emplace_back(kernel, name, ++nKernels);
+                return true;
+            }
+            IT_ASSERT(!hasDefault[i], "Kernel already registered");
+            hasDefault[i] = true;
+            vector<KernelRecord> withDefault{{kernel, name, ++nKernels}};
+            for (auto &record : records)
+                withDefault.emplace_back(record);
+            records.swap(withDefault);
+            resolve(key);
             return true;
         }
         Kernel *getKernel(const KernelAttrs &kernelAttrs) const
         {
-            auto it = kernels.find(kernelAttrs);
-            IT_ASSERT(it != kernels.end(), "Kernel not found for key {" +
-                                               get_kernel_attrs_str(kernelAttrs) +
-                                               "}");
-            return std::get<0>(it->second);
+            return std::get<0>(getKernelItem(kernelAttrs));
         }
         const KernelRecord &getKernelItem(const KernelAttrs &kernelAttrs) const
         {
-            return kernels.at(kernelAttrs);
+            return getCandidates(kernelAttrs).front();
+        }
+        // The default kernel followed by the alternative candidates.
+        const vector<KernelRecord> &
+        getCandidates(const KernelAttrs &kernelAttrs) const
+        {
+            auto records = dispatch[index(kernelAttrs)];
+            IT_ASSERT(records, "Kernel not found for key {" +
+                                   get_kernel_attrs_str(kernelAttrs) + "}");
+            return *records;
         }
     };
 
+    /**
+     * @brief CPU kernels resolve pointers, sizes and strides in prepare() and
+     * only do the math in run(); compute() is the two in a row.
+     */
     class CpuKernelWithoutConfig : public Kernel
     {
     public:
-        virtual void compute(const Operator &op,
-                             const RuntimeObj *context) const = 0;
+        void compute(const Operator &op,
+                     const RuntimeObj *context) const override
+        {
+            run(*prepare(op, tensorData), context);
+        }
+        std::unique_ptr<KernelState>
+        prepare(const Operator &op, const DataBinding &data) const override = 0;
+        void run(const KernelState &state,
+                 const RuntimeObj *context) const override = 0;
     };
 
 } // namespace infini
@@ -83,5 +203,30 @@ namespace infini
                                                          new kernel(), name); \
     }
 
+#define _REGISTER_KERNEL_CANDIDATE_1(device, opType, kernel, name, cnt)       \
+    namespace infini                                                          \
+    {                                                                         \
+        static const bool _CAT(_register_kernel_, cnt) =                      \
+            KernelRegistry::getInstance().registerKernel(                     \
+                KernelAttrs{device, opType}, new kernel(), name, true);       \
+    }
+
+#define _REGISTER_TYPED_KERNEL_1(device, opType, dtype, kernel, name, cnt) \
+    namespace infini                                                          \
+    {                                                                         \
+        static const bool _CAT(_register_kernel_, cnt) =                      \
+            KernelRegistry::getInstance().registerKernel(                     \
+                KernelAttrs{device, opType, dtype}, new kernel(), name);      \
+    }
+
 #define REGISTER_KERNEL(device, opType, kernel, name) \
     _REGISTER_KERNEL_1(device, opType, kernel, name, __COUNTER__)
+
+// Register the default kernel for one data type, taking precedence over the
+// kernel registered for all types.
+#define REGISTER_TYPED_KERNEL(device, opType, dtype, kernel, name) \
+    _REGISTER_TYPED_KERNEL_1(device, opType, dtype, kernel, name, __COUNTER__)
+
+// Register an alternative implementation for the autotuner to choose from.
+#define REGISTER_KERNEL_CANDIDATE(device, opType, kernel, name) \
+    _REGISTER_KERNEL_CANDIDATE_1(device, opType, kernel, name, __COUNTER__)
@@ -0,0 +1,91 @@
+#pragma once
+#include "core/allocator.h"
+#include "core/runtime.h"
+
+namespace infini {
+  // Lifetime of a buffer in execution order. A buffer defined by the op at
+  // step `first` must stay valid until the op at step `last` has run; both
+  // ends are inclusive, so an op's inputs never share memory with its
+  // outputs.
+  struct TensorLifetime
+  {
+    size_t size;
+    size_t first;
+    size_t last;
+  };
+
+  struct MemoryPlan
+  {
+    string strategy;
+    vector<size_t> offsets; // one per lifetime, in input order
+    size_t peak;            // arena size needed by the offsets
+    size_t lowerBound;      // max bytes live at any single step
+
+    void info() const;
+  };
+
+  /**
+   * @brief A memory plan in terms of a symbolic dimension n, computed once
+   * and instantiated for any n without planning again: buffer i sits at
+   * offsets[i] + scales[i] * n, in an arena of peak + peakScale * n bytes.
+   */
+  struct ParametricMemoryPlan
+  {
+    vector<size_t> offsets, scales;
+    size_t peak, peakScale;
+
+    MemoryPlan instantiate(size_t n) const;
+  };
+
+  /**
+   * @brief Offline memory planner. Unlike Allocator, which simulates
+   * malloc/free in execution order, the planner sees every lifetime up front
+   * and packs them with several interval-packing heuristics, keeping the plan
+   * with the smallest arena.
+   */
+  class MemoryPlanner
+  {
+  private:
+    Runtime runtime;
+
+    size_t alignment;
+
+  public:
+    MemoryPlanner(Runtime runtime);
+
+    // function: run every strategy and keep the plan with the smallest peak
+    MemoryPlan plan(const vector<TensorLifetime> &lifetimes,
+                    AllocPolicy policy = AllocPolicy::BestFit) const;
+
+    // function: plan buffers whose size is lifetimes[i].size bytes per unit
+    // of a symbolic dimension if scaled[i], and lifetimes[i].size bytes
+    // otherwise
+    ParametricMemoryPlan planParametric(const vector<TensorLifetime> &lifetimes,
+                                        const vector<bool> &scaled,
+                                        AllocPolicy policy = AllocPolicy::BestFit) const;
+
+    // function: replay allocs/frees in execution order through Allocator
+    MemoryPlan planOnline(const vector<TensorLifetime> &lifetimes,
+                          AllocPolicy policy) const;
+
+    // function: place buffers from largest to smallest, each into the
+    // tightest gap left by already placed buffers with overlapping lifetimes
+    MemoryPlan planGreedyBySize(const vector<TensorLifetime> &lifetimes) const;
+
+    // function: visit steps from the one with the most live bytes down and
+    // place the buffers live at each step, largest first
+    MemoryPlan
+    planGreedyByBreadth(const vector<TensorLifetime> &lifetimes) const;
+
+    // function: maximum number of bytes live at the same step, which no
+    // valid plan can beat
+    size_t lowerBound(const vector<TensorLifetime> &lifetimes) const;
+
+  private:
+    size_t getAlignedSize(size_t size) const;
+
+    // function: place lifetimes in the given order with best-fit gaps
+    MemoryPlan placeInOrder(const vector<TensorLifetime> &lifetimes,
+                            const vector<size_t> &order) const;
+  };
+} // namespace infini
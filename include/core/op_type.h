@@ -24,7 +24,12 @@ namespace infini
             Relu,
             Sub,
             Transpose,
+            QuantizedMatMul,
+            QuantizeLinear,
+            DequantizeLinear,
 
+            // number of op types, keep it last
+            NumOpTypes
         } type;
 
         constexpr OpType(decltype(type) t) : type(t) {}
@@ -5,9 +5,19 @@
 
 namespace infini
 {
-    using KernelAttrs = std::tuple<Device, OpType::underlying_t>;
+    /**
+     * @brief Key of a kernel in the registry. A kernel registered with dtype
+     * Undefine serves every data type that has no kernel of its own.
+     */
+    struct KernelAttrs
+    {
+        Device device;
+        OpType::underlying_t opType;
+        DataType dtype = DataType::Undefine;
+    };
 
     class GraphObj;
+    class Kernel;
     class OperatorObj : public Object
     {
         friend class GraphObj;
@@ -18,6 +28,8 @@ namespace infini
         TensorVec outputs;
         vector<WRef<OperatorObj>> predecessors;
         vector<WRef<OperatorObj>> successors;
+        // kernel picked by the autotuner, nullptr for the registry default
+        Kernel *kernel = nullptr;
 
     public:
         OperatorObj(OpType opType, TensorVec inputs, TensorVec outputs);
@@ -52,6 +64,14 @@ namespace infini
         // HACK: set correct data type
         DataType getDType() const { return getInputs(0)->getDType(); }
         DataType getOutDType() const { return getOutput()->getDType(); }
+        Kernel *getKernel() const { return kernel; }
+        void setKernel(Kernel *tuned) { kernel = tuned; }
+        /**
+         * @brief Attributes that, besides the input shapes and dtype, change
+         * the work done by the operator. Part of the autotuner's cache key.
+         */
+        virtual vector<int> getOpAttrVector() const { return {}; }
+
         virtual int numInputs() const = 0;
         virtual int numOutputs() const = 0;
 
@@ -0,0 +1,97 @@
+#pragma once
+#include "core/execution_plan.h"
+#include <list>
+
+namespace infini
+{
+    /**
+     * @brief Execution plans of one graph for the input shapes seen so far,
+     * for traffic that alternates between a few shapes. Each entry keeps the
+     * shapes inferred for every tensor, an arena laid out by the memory plan
+     * of the inputs and computed tensors for those shapes, and kernels
+     * prepared on that arena; weights stay in the graph's blobs. Selecting cached shapes only switches the current
+     * entry. Up to `capacity` entries are kept, the least recently used
+     * being evicted first.
+     *
+     * Given the input shapes with a symbolic dimension, the cache also plans
+     * memory once for every value of it. Shapes that only differ in that
+     * value then skip memory planning on a miss, instantiating the
+     * parametric plan instead.
+     *
+     * Build it after dataMalloc (and tune), once the weights are filled in.
+     * The graph keeps its own shapes and memory. Not thread-safe.
+     */
+    class PlanCacheObj
+    {
+    private:
+        struct Entry
+        {
+            vector<Shape> key;
+            // shapes and arena offsets of the tensors, in getTensors() order
+            vector<Shape> shapes;
+            vector<size_t> offsets;
+            void *arena;
+            ExecutionPlan plan;
+        };
+
+        Graph graph;
+        // the other graph inputs, which no entry's arena holds
+        TensorVec inputs, weights;
+        size_t capacity;
+        unordered_map<TensorObj *, size_t> tensorIndex;
+        // most recently used first
+        std::list<Entry> entries;
+        std::map<vector<Shape>, std::list<Entry>::iterator> index;
+        size_t hits = 0, misses = 0, instantiations = 0;
+        // the symbolic dimension, the shapes of the tensors in terms of it
+        // and the memory plan for any value of it; symbol is 0 if unused
+        ShapeElem symbol = 0;
+        vector<Shape> symbolicShapes;
+        ParametricMemoryPlan parametricPlan;
+
+        // Calls fn with the inputs set to these shapes and the other shapes
+        // inferred from them, then restores the graph's shapes.
+        void withShapes(const vector<Shape> &inputShapes,
+                        const std::function<void()> &fn);
+        // The value of `symbol` giving the current shapes, or 0.
+        ShapeElem matchSymbol() const;
+        Entry build(const vector<Shape> &inputShapes);
+        // Prepares the kernels of an entry whose arena is laid out.
+        void prepare(Entry &entry) const;
+        const Entry &current() const;
+
+    public:
+        /**
+         * @param inputs The graph inputs whose shapes vary; the other graph
+         * inputs are weights.
+         * @param symbolicInputShapes If not empty, the shapes of `inputs`
+         * with one symbolic dimension in all, such as the batch size.
+         */
+        PlanCacheObj(const Graph &graph, const TensorVec &inputs,
+                     size_t capacity = 8,
+                     const vector<Shape> &symbolicInputShapes = {});
+        ~PlanCacheObj();
+        PlanCacheObj(const PlanCacheObj &) = delete;
+        PlanCacheObj &operator=(const PlanCacheObj &) = delete;
+
+        /**
+         * @brief Makes the plan for inputs of these shapes current, one
+         * shape per input. Builds it on a miss: shape inference, memory
+         * planning and kernel preparation. Returns whether it was cached.
+         */
+        bool select(const vector<Shape> &inputShapes);
+
+        // Data and shape of `tensor` under the current plan.
+        void *getData(const Tensor &tensor) const;
+        const Shape &getDims(const Tensor &tensor) const;
+        // Runs the current plan.
+        void run() const;
+
+        size_t size() const { return entries.size(); }
+        size_t getHits() const { return hits; }
+        size_t getMisses() const { return misses; }
+        // Misses served by the parametric memory plan.
+        size_t getInstantiations() const { return instantiations; }
+    };
+
+} // namespace infini
@@ -0,0 +1,25 @@
+#pragma once
+#include "core/tensor.h"
+
+namespace infini {
+  // One set of calibration inputs: Float32 data for graph input tensors.
+  // Graph inputs that are not fed are treated as constant weights and must
+  // hold their data already.
+  using CalibrationSample = unordered_map<Tensor, vector<float>>;
+
+  // Observed real range of a tensor over all calibration samples.
+  struct TensorRange
+  {
+    float min;
+    float max;
+  };
+
+  struct QuantizationReport
+  {
+    size_t quantizedOps;  // MatMuls rewritten to QuantizedMatMul
+    size_t foldedPairs;   // DequantizeLinear/QuantizeLinear pairs removed
+    vector<double> sqnr;  // dB per graph output, over all calibration samples
+
+    void info() const;
+  };
+} // namespace infini
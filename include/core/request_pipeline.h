@@ -0,0 +1,54 @@
+#pragma once
+#include "core/compiled_model.h"
+#include <condition_variable>
+#include <future>
+#include <mutex>
+
+namespace infini
+{
+    /**
+     * @brief Serves a stream of requests on one model with double-buffered
+     * activations. Every slot is an ExecutionContext of the model. submit()
+     * copies a request's inputs into a free slot on the calling thread and
+     * queues its run on the runtime's request thread, so that request N+1
+     * is staged while request N computes.
+     */
+    class RequestPipelineObj
+    {
+    private:
+        CompiledModel model;
+        TensorVec outputs;
+        vector<ExecutionContext> slots;
+        std::mutex mutex;
+        std::condition_variable slotReleased;
+        vector<size_t> freeSlots;
+
+    public:
+        /**
+         * @param outputs The tensors returned to the caller. Defaults to the
+         * graph outputs.
+         * @param depth Number of slots, i.e. of requests staged or running at
+         * the same time.
+         */
+        RequestPipelineObj(const CompiledModel &model,
+                           const TensorVec &outputs = {}, size_t depth = 2);
+        // Waits for the requests in flight.
+        ~RequestPipelineObj();
+        RequestPipelineObj(const RequestPipelineObj &) = delete;
+        RequestPipelineObj &operator=(const RequestPipelineObj &) = delete;
+
+        /**
+         * @brief Copies `inputData[i]` into the model's inputs[i] in a free
+         * slot, waiting for one if all are in use, and queues the request.
+         * Once it has run, outputs[i] is copied to `outputData[i]` and the
+         * future becomes ready, rethrowing any error of the run. The input
+         * buffers can be reused as soon as submit() returns.
+         */
+        std::future<void> submit(const vector<const void *> &inputData,
+                                 const vector<void *> &outputData);
+
+        const TensorVec &getInputs() const { return model->getInputs(); }
+        const TensorVec &getOutputs() const { return outputs; }
+    };
+
+} // namespace infini
@@ -2,6 +2,10 @@
 #include "core/common.h"
 #include "core/op_type.h"
 #include "core/ref.h"
+#include "utils/serial_executor.h"
+#include "utils/thread_pool.h"
+#include <future>
+#include <mutex>
 
 namespace infini
 {
@@ -10,12 +14,14 @@ namespace infini
   class GraphObj;
   class RuntimeObj;
   class BlobObj;
+  class ExecutionPlanObj;
 
   using Tensor = Ref<TensorObj>;
   using Operator = Ref<OperatorObj>;
   using Graph = Ref<GraphObj>;
   using Runtime = Ref<RuntimeObj>;
   using Blob = Ref<BlobObj>;
+  using ExecutionPlan = Ref<ExecutionPlanObj>;
 
   using TensorVec = vector<Tensor>;
   using OpVec = vector<Operator>;
@@ -29,15 +35,73 @@ namespace infini
   {
   protected:
     Device device;
+    // workers shared by the kernels' parallel loops and by operators
+    // running concurrently
+    std::unique_ptr<ThreadPool> threadPool;
+    size_t interOpThreads = 1;
+    // thread running the requests of runAsync() and post(), started by the
+    // first of them
+    mutable std::once_flag requestThreadStarted;
+    mutable std::unique_ptr<SerialExecutor> requestThread;
 
   public:
     explicit RuntimeObj(Device device)
-        : device(device) {}
+        : device(device)
+    {
+      setNumThreads(0);
+    }
     RuntimeObj(RuntimeObj &other) = delete;
     RuntimeObj &operator=(RuntimeObj const &) = delete;
     virtual ~RuntimeObj() {}
 
+    Device getDevice() const { return device; }
+
     virtual void run(const Graph &graph) const = 0;
+    // Runs a prepared plan, with the inter-op parallelism set by
+    // setInterOpThreads().
+    void run(const ExecutionPlanObj &plan) const;
+    /**
+     * @brief Queues run(graph) on the runtime's request thread and returns
+     * at once, so that the caller can prepare the next request meanwhile.
+     * Queued requests run one at a time, in order. The future becomes ready
+     * when the run is done and rethrows what it threw; the graph's data must
+     * not be touched until then. The runtime must outlive its requests.
+     */
+    std::future<void> runAsync(const Graph &graph) const;
+    // Queues any task behind the requests already queued.
+    std::future<void> post(std::function<void()> task) const;
+    /**
+     * @brief Autotune a graph after dataMalloc. For every op with several
+     * candidate kernels, times each on the op's real shapes and keeps the
+     * fastest; choices already in TuningCache are reused without timing. If
+     * cachePath is not empty, the cache file is loaded first and saved
+     * afterwards.
+     */
+    void tune(const Graph &graph, const string &cachePath = "") const;
+    /**
+     * @brief Threads of this runtime, the thread calling run() included.
+     * Kernels split their loops among them with
+     * getThreadPool().parallelFor(), so that each runtime can be capped on
+     * its own without touching the environment. 0, the default, uses every
+     * hardware thread. If `cores` is not empty, the workers are pinned to
+     * those cores in turn; the calling thread keeps its own affinity.
+     */
+    void setNumThreads(size_t threads, const vector<int> &cores = {});
+    size_t getNumThreads() const { return threadPool->size() + 1; }
+    ThreadPool &getThreadPool() const { return *threadPool; }
+    /**
+     * @brief Inter-operator parallelism: with more than one thread, run()
+     * starts every operator as soon as its inputs are ready, so that up to
+     * that many independent operators run concurrently on the runtime's
+     * threads. 1, the default, runs operators one after another.
+     * Set it before dataMalloc(), which keeps concurrent operators' tensors
+     * apart only when planning for more than one thread.
+     */
+    void setInterOpThreads(size_t threads)
+    {
+      interOpThreads = std::max<size_t>(1, threads);
+    }
+    size_t getInterOpThreads() const { return interOpThreads; }
     virtual void *alloc(size_t size) = 0;
     virtual void dealloc(void *ptr) = 0;
 
@@ -61,6 +125,7 @@ namespace infini
       return instance;
     }
     void dealloc(void *ptr) override;
+    using RuntimeObj::run;
     void run(const Graph &graph) const override;
     void *alloc(size_t size) override;
     string toString() const override;
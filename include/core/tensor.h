@@ -12,6 +12,17 @@ namespace infini
     class GraphObj;
     using ShapeElem = int;
     using Shape = vector<ShapeElem>;
+
+    // A negative ShapeElem is a symbolic dimension, such as a batch size only
+    // known at run time. The same name always gives the same symbol, so that
+    // shape inference can tell equal dimensions apart from unrelated ones.
+    ShapeElem symbolicDim(const string &name);
+    string getSymbolName(ShapeElem symbol);
+    inline bool isSymbolic(ShapeElem dim) { return dim < 0; }
+    bool isSymbolic(const Shape &shape);
+    // `shape` with every occurrence of `symbol` replaced by `value`.
+    Shape substitute(Shape shape, ShapeElem symbol, ShapeElem value);
+
     class TensorObj : public Object
     {
         friend class GraphObj;
@@ -148,6 +159,7 @@ namespace infini
         }
 
         void addTarget(const Operator &op) { targets.emplace_back(op); }
+        void clearTargets() { targets.clear(); }
         void setSource(const Operator &op) { source = op; }
         void removeTarget(const Operator &op)
         {
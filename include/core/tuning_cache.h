@@ -0,0 +1,54 @@
+#pragma once
+#include "core/common.h"
+#include "core/runtime.h"
+#include <mutex>
+
+namespace infini {
+  /**
+   * @brief Kernels picked by the autotuner, keyed by op type, dtype, input
+   * shapes, op attributes, the runtime's thread count and the host CPU. Kept
+   * in memory for the whole process and optionally persisted to a text file
+   * with one "key<TAB>kernel name" entry per line, so that later runs skip
+   * tuning. Safe to use from several threads, such as runtimes tuning while
+   * others serve requests.
+   */
+  class TuningCache
+  {
+  private:
+    map<string, string> choices;
+    mutable std::mutex mutex;
+
+  public:
+    static TuningCache &getInstance()
+    {
+      static TuningCache instance;
+      return instance;
+    }
+
+    // function: cache key of an operator run with `threads` threads on this
+    // host
+    static string getKey(const Operator &op, size_t threads);
+
+    optional<string> get(const string &key) const;
+
+    void set(const string &key, const string &kernelName);
+
+    size_t size() const
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      return choices.size();
+    }
+
+    void clear()
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      choices.clear();
+    }
+
+    // function: merge the entries of a cache file, a missing file is empty
+    void load(const string &path);
+
+    // function: write every entry to a cache file
+    void save(const string &path) const;
+  };
+} // namespace infini
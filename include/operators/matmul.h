@@ -47,6 +47,7 @@ namespace infini
 
         int numInputs() const override { return inputs.size(); }
         int numOutputs() const override { return 1; }
+        vector<int> getOpAttrVector() const override { return {transA, transB}; }
 
         bool getTransA() const { return transA; }
         bool getTransB() const { return transB; }
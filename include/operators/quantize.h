@@ -0,0 +1,105 @@
+#pragma once
+#include "core/operator.h"
+
+namespace infini
+{
+    /**
+     * @brief Affine quantization parameters, real = scale * (q - zeroPoint).
+     * A single entry applies to the whole tensor; otherwise there is one entry
+     * per channel.
+     */
+    struct QuantParams
+    {
+        vector<float> scale;
+        vector<int> zeroPoint;
+
+        QuantParams(float scale = 1.f, int zeroPoint = 0)
+            : scale{scale}, zeroPoint{zeroPoint} {}
+        QuantParams(vector<float> scale, vector<int> zeroPoint)
+            : scale(std::move(scale)), zeroPoint(std::move(zeroPoint)) {}
+
+        /**
+         * @brief Int8 parameters covering the real range [min, max], which is
+         * widened to contain 0 so that zero is represented exactly.
+         */
+        static QuantParams fromRange(float min, float max);
+
+        size_t size() const { return scale.size(); }
+        float getScale(size_t channel) const
+        {
+            return scale[scale.size() == 1 ? 0 : channel];
+        }
+        int getZeroPoint(size_t channel) const
+        {
+            return zeroPoint[zeroPoint.size() == 1 ? 0 : channel];
+        }
+        bool operator==(const QuantParams &rhs) const
+        {
+            return scale == rhs.scale && zeroPoint == rhs.zeroPoint;
+        }
+        string toString() const;
+    };
+
+    /**
+     * @brief Quantize a Float32 tensor to Int8 with per-tensor parameters,
+     * y = saturate(round(x / scale) + zeroPoint).
+     *
+     */
+    class QuantizeLinearObj : public OperatorObj
+    {
+    public:
+        /**
+         * @brief Construct a new QuantizeLinear object.
+         *
+         * @param graph The computation graph that this operator belongs to.
+         * @param input The Float32 input tensor.
+         * @param output The Int8 output tensor.
+         * @param params Per-tensor quantization parameters.
+         */
+        QuantizeLinearObj(GraphObj *graph, Tensor input, Tensor output,
+                          QuantParams params);
+        OP_CLONE(QuantizeLinearObj);
+        optional<vector<Shape>> inferShape(const TensorVec &inputs) override;
+        vector<DataType> inferDataType(const TensorVec &inputs) const override;
+
+        std::string toString() const override;
+        int numInputs() const override { return 1; }
+        int numOutputs() const override { return 1; }
+        const QuantParams &getParams() const { return params; }
+
+    private:
+        QuantParams params;
+    };
+
+    /**
+     * @brief Dequantize an Int8 tensor to Float32 with per-tensor parameters,
+     * y = (x - zeroPoint) * scale.
+     *
+     */
+    class DequantizeLinearObj : public OperatorObj
+    {
+    public:
+        /**
+         * @brief Construct a new DequantizeLinear object.
+         *
+         * @param graph The computation graph that this operator belongs to.
+         * @param input The Int8 input tensor.
+         * @param output The Float32 output tensor.
+         * @param params Per-tensor quantization parameters.
+         */
+        DequantizeLinearObj(GraphObj *graph, Tensor input, Tensor output,
+                            QuantParams params);
+        OP_CLONE(DequantizeLinearObj);
+        optional<vector<Shape>> inferShape(const TensorVec &inputs) override;
+        vector<DataType> inferDataType(const TensorVec &inputs) const override;
+
+        std::string toString() const override;
+        int numInputs() const override { return 1; }
+        int numOutputs() const override { return 1; }
+        const QuantParams &getParams() const { return params; }
+
+    private:
+        QuantParams params;
+    };
+
+} // namespace infini
@@ -0,0 +1,63 @@
+#pragma once
+#include "operators/quantize.h"
+
+namespace infini
+{
+    /**
+     * @brief Matrix multiplication on 8-bit quantized operands with int32
+     * accumulation.
+     *
+     */
+    class QuantizedMatmulObj : public OperatorObj
+    {
+    private:
+        bool transB;
+        QuantParams aParams, bParams;
+        // quantization of the output; without it the output is dequantized
+        optional<QuantParams> cParams;
+
+        // Auxiliary attributes which are not a part of operator attributes.
+        int m, n, k;
+
+    public:
+        /**
+         * @brief Construct a new QuantizedMatmul object, the quantized
+         * counterpart of a Matmul whose B is a weight matrix.
+         *
+         * @param graph The computation graph that this operator belongs to.
+         * @param A Activations of shape [..., m, k], Int8 or UInt8, quantized
+         * per tensor.
+         * @param B Weights of shape [k, n] ([n, k] if transB), Int8, quantized
+         * per tensor or per output channel (n). Kernels pack B when they
+         * are prepared, so its data must be in place by then.
+         * @param C The output of shape [..., m, n]. If outputs are going to be
+         * created in the constructor, C should be an empty Ref.
+         * @param aParams Quantization of A.
+         * @param bParams Quantization of B.
+         * @param cParams If set, C is requantized to Int8 with these per-tensor
+         * parameters; otherwise C is dequantized to Float32.
+         * @param transB If matrix B should be transposed when computing.
+         */
+        QuantizedMatmulObj(GraphObj *graph, Tensor A, Tensor B, Tensor C,
+                           QuantParams aParams, QuantParams bParams,
+                           optional<QuantParams> cParams = std::nullopt,
+                           bool transB = false);
+        OP_CLONE(QuantizedMatmulObj);
+
+        std::string toString() const override;
+        optional<vector<Shape>> inferShape(const TensorVec &inputs) override;
+        vector<DataType> inferDataType(const TensorVec &inputs) const override;
+
+        int numInputs() const override { return 2; }
+        int numOutputs() const override { return 1; }
+
+        bool getTransB() const { return transB; }
+        const QuantParams &getAParams() const { return aParams; }
+        const QuantParams &getBParams() const { return bParams; }
+        const optional<QuantParams> &getCParams() const { return cParams; }
+        int getM() const { return m; }
+        int getN() const { return n; }
+        int getK() const { return k; }
+    };
+
+} // namespace infini
@@ -0,0 +1,35 @@
+#pragma once
+#ifndef CPU_FEATURES_H
+#define CPU_FEATURES_H
+
+#include <string>
+
+namespace infini {
+
+// SIMD instruction set levels, ordered so that a higher level implies the
+// lower ones.
+enum class CpuIsa {
+    Generic = 0, // no hand-vectorized kernels
+    SSE41,
+    AVX2,   // AVX2 + FMA + F16C
+    AVX512, // AVX-512F
+};
+
+// The best instruction set of the host, detected once from cpuid at load
+// time. The INFINI_CPU_ISA environment variable (generic, sse41, avx2 or
+// avx512) caps the level, e.g. to exercise fallback kernels.
+CpuIsa getCpuIsa();
+
+const char *cpuIsaToString(CpuIsa isa);
+
+// Whether the host has AVX-512 VNNI with 256-bit (VL) encodings for int8 dot
+// products. Always false when getCpuIsa() is below AVX512.
+bool cpuHasVnni();
+
+// The processor's model name, e.g. for keying tuning results; "unknown" if it
+// cannot be read.
+const std::string &getCpuModel();
+
+} // namespace infini
+
+#endif
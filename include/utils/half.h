@@ -0,0 +1,80 @@
+#pragma once
+#ifndef HALF_H
+#define HALF_H
+
+#include "core/data_type.h"
+#include <cstdint>
+#include <cstring>
+
+namespace infini {
+
+// Scalar conversions between float and the 16-bit storage types. Float16 is
+// IEEE binary16 and BFloat16 is the upper half of a binary32; both are kept
+// as uint16_t bit patterns (see DT<10> and DT<16>). Narrowing rounds to
+// nearest even and overflows to infinity. NaN stays NaN with the quiet bit
+// set and the high payload bits kept, as F16C does. Bulk conversions should
+// go through the vectorized cast kernels instead.
+
+inline uint32_t floatBits(float f) {
+    uint32_t u;
+    std::memcpy(&u, &f, sizeof(u));
+    return u;
+}
+
+inline float bitsToFloat(uint32_t u) {
+    float f;
+    std::memcpy(&f, &u, sizeof(f));
+    return f;
+}
+
+inline float bf16ToFloat(uint16_t h) { return bitsToFloat(uint32_t(h) << 16); }
+
+inline uint16_t floatToBf16(float f) {
+    uint32_t u = floatBits(f);
+    if ((u & 0x7fffffffu) > 0x7f800000u)
+        return uint16_t((u >> 16) | 0x40);
+    return uint16_t((u + 0x7fffu + ((u >> 16) & 1)) >> 16);
+}
+
+inline float fp16ToFloat(uint16_t h) {
+    // move exponent and mantissa into place and rebias the exponent
+    uint32_t o = uint32_t(h & 0x7fff) << 13;
+    uint32_t exp = o & 0x0f800000u;
+    o += (127 - 15) << 23;
+    if (exp == 0x0f800000u) { // Inf or NaN, which is quieted
+        o += (128 - 16) << 23;
+        if (o & 0x007fffffu)
+            o |= 0x00400000u;
+    } else if (exp == 0) // zero or subnormal: renormalize through the FPU
+        o = floatBits(bitsToFloat(o + (1 << 23)) - bitsToFloat(113 << 23));
+    return bitsToFloat(o | uint32_t(h & 0x8000) << 16);
+}
+
+inline uint16_t floatToFp16(float f) {
+    uint32_t u = floatBits(f);
+    uint32_t sign = u & 0x80000000u;
+    u ^= sign;
+    uint32_t o;
+    if (u >= (127 + 16) << 23) // too large for a half, Inf or NaN
+        o = u > 0x7f800000u ? 0x7e00 | ((u >> 13) & 0x3ff) : 0x7c00;
+    else if (u < 113 << 23) {
+        // subnormal or zero: let the FPU round by adding a magic number
+        // whose ulp is the smallest half subnormal
+        const uint32_t magic = ((127 - 15) + (23 - 10) + 1) << 23;
+        o = floatBits(bitsToFloat(u) + bitsToFloat(magic)) - magic;
+    } else {
+        uint32_t mantOdd = (u >> 13) & 1;
+        u = u - ((127 - 15) << 23) + 0xfff + mantOdd;
+        o = u >> 13;
+    }
+    return uint16_t(o | sign >> 16);
+}
+
+// Bulk conversions of Float16 or BFloat16 data (`type`) through the vector
+// cast kernels, falling back to the scalar conversions above.
+void halfToFloat(DataType type, const uint16_t *x, float *y, size_t n);
+void floatToHalf(DataType type, const float *x, uint16_t *y, size_t n);
+
+} // namespace infini
+
+#endif
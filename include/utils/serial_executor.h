@@ -0,0 +1,43 @@
+#pragma once
+#ifndef SERIAL_EXECUTOR_H
+#define SERIAL_EXECUTOR_H
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <thread>
+
+namespace infini {
+
+/**
+ * @brief One thread running tasks in the order they were posted. Runs of a
+ * graph share its buffers, so requests queued on the same executor never
+ * overlap each other, only the work their callers do in the meantime.
+ */
+class SerialExecutor {
+  public:
+    SerialExecutor();
+    // Runs the tasks still queued, then stops the thread.
+    ~SerialExecutor();
+    SerialExecutor(const SerialExecutor &) = delete;
+    SerialExecutor &operator=(const SerialExecutor &) = delete;
+
+    // Queues a task. The future becomes ready when it has run, and rethrows
+    // what it threw.
+    std::future<void> post(std::function<void()> task);
+
+  private:
+    std::mutex mutex;
+    std::condition_variable taskQueued;
+    std::deque<std::packaged_task<void()>> tasks;
+    bool stopping = false;
+    std::thread thread;
+
+    void loop();
+};
+
+} // namespace infini
+
+#endif // SERIAL_EXECUTOR_H
@@ -0,0 +1,80 @@
+#pragma once
+#ifndef THREAD_POOL_H
+#define THREAD_POOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace infini {
+
+/**
+ * @brief A fixed set of worker threads with one task deque each. Workers
+ * run their own tasks newest first and, when they run dry, steal the oldest
+ * task of another worker, so tasks spawned by a running task stay on the
+ * same thread while idle threads pick up the rest.
+ *
+ * A pool without workers is valid: its tasks run on the threads waiting for
+ * them.
+ */
+class ThreadPool {
+  public:
+    using Task = std::function<void()>;
+
+    // Workers are pinned to `cores` in turn if it is not empty (Linux only).
+    explicit ThreadPool(size_t nThreads, const std::vector<int> &cores = {});
+    ~ThreadPool();
+    ThreadPool(const ThreadPool &) = delete;
+    ThreadPool &operator=(const ThreadPool &) = delete;
+
+    size_t size() const { return workers.size(); }
+
+    // Queues a task. A worker of this pool queues on its own deque, any
+    // other thread on the deques in turn.
+    void submit(Task task);
+
+    // Runs queued tasks on the calling thread until `done` returns true.
+    // `done` is checked again whenever a task finishes.
+    void waitUntil(const std::function<bool()> &done);
+
+    /**
+     * @brief Splits [0, range) into contiguous chunks of at least `grain`
+     * iterations, at most one per thread, and calls fn(begin, end) on each,
+     * the calling thread taking the first. Ranges of up to `grain`
+     * iterations run on the calling thread alone. Returns when every chunk
+     * is done, rethrowing the first exception thrown by `fn`.
+     */
+    void parallelFor(size_t range, size_t grain,
+                     const std::function<void(size_t, size_t)> &fn);
+
+  private:
+    struct Queue {
+        std::mutex mutex;
+        std::deque<Task> tasks;
+    };
+
+    std::vector<std::unique_ptr<Queue>> queues;
+    std::vector<std::thread> workers;
+    std::atomic<size_t> pending{0}, nextQueue{0};
+    // idle workers sleep on taskQueued, threads in waitUntil on taskDone
+    std::mutex mutex;
+    std::condition_variable taskQueued, taskDone;
+    size_t waiters = 0;
+    bool stopping = false;
+
+    // queue of the calling thread, or -1 if it is not a worker of this pool
+    int ownQueue() const;
+    // pops a task of queue `self` or steals one; false if all are empty
+    bool tryRunOne(int self);
+    void workerLoop(int self);
+};
+
+} // namespace infini
+
+#endif // THREAD_POOL_H
@@ -0,0 +1,70 @@
+#pragma once
+#ifndef VECTORIZED_H
+#define VECTORIZED_H
+
+#include "core/data_type.h"
+#include "utils/cpu_features.h"
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+namespace infini {
+
+enum class VecBinary { Add = 0, Sub, Mul, Div, Count };
+
+// Number of DataType indices, so that the tables below grow with DataType.
+constexpr int NUM_DATA_TYPES = DataType::count;
+
+/**
+ * @brief Table of hand-vectorized kernels for one instruction set. Every
+ * kernel works on a contiguous run of n elements. Binary kernels take input
+ * strides of 0 or 1, a zero stride broadcasting the first element. Entries
+ * without a vector implementation (e.g. integer division) are nullptr, and
+ * callers fall back to their scalar loops.
+ */
+struct VectorKernels {
+    template <typename T>
+    using BinaryRun = void (*)(const T *a, size_t sa, const T *b, size_t sb,
+                               T *c, size_t n);
+    template <typename T> using UnaryRun = void (*)(const T *x, T *y, size_t n);
+    template <typename T>
+    using ClipRun = void (*)(const T *x, T *y, size_t n, T lo, T hi);
+    using CastRun = void (*)(const void *x, void *y, size_t n);
+
+    CpuIsa isa = CpuIsa::Generic;
+    BinaryRun<float> binaryF32[(int)VecBinary::Count] = {};
+    BinaryRun<uint32_t> binaryU32[(int)VecBinary::Count] = {};
+    UnaryRun<float> reluF32 = nullptr;
+    ClipRun<float> clipF32 = nullptr;
+    ClipRun<uint32_t> clipU32 = nullptr;
+    // Element type conversions indexed by the DataType indices of source and
+    // destination. Float16/BFloat16 round to nearest even. Floats become
+    // integers by truncation, narrowing integers wrap, and values out of the
+    // destination range are unspecified, as for ONNX Cast.
+    CastRun cast[NUM_DATA_TYPES][NUM_DATA_TYPES] = {};
+
+    template <typename T> BinaryRun<T> binary(VecBinary op) const {
+        if constexpr (std::is_same_v<T, float>)
+            return binaryF32[(int)op];
+        else if constexpr (std::is_same_v<T, uint32_t>)
+            return binaryU32[(int)op];
+        else
+            return nullptr;
+    }
+};
+
+// Kernels for the best instruction set of the host, picked once at load time.
+const VectorKernels &getVectorKernels();
+
+// Kernels for a specific instruction set, which must not exceed getCpuIsa().
+const VectorKernels &getVectorKernels(CpuIsa isa);
+
+// Per-ISA initializers, each compiled in its own translation unit with the
+// matching target flags.
+void initVectorKernelsSse41(VectorKernels &kernels);
+void initVectorKernelsAvx2(VectorKernels &kernels);
+void initVectorKernelsAvx512(VectorKernels &kernels);
+
+} // namespace infini
+
+#endif
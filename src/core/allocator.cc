@@ -4,7 +4,8 @@
 
 namespace infini
 {
-    Allocator::Allocator(Runtime runtime) : runtime(runtime)
+    Allocator::Allocator(Runtime runtime, AllocPolicy policy)
+        : runtime(runtime), policy(policy)
     {
         used = 0;
         peak = 0;
@@ -30,27 +31,34 @@ namespace infini
         IT_ASSERT(this->ptr == nullptr);
         size = this->getAlignedSize(size);
 
-        for (auto it = freeBlocks.begin(); it != freeBlocks.end(); ++it)
+        auto it = findFreeBlock(size);
+        if (it != freeBlocks.end())
         {
-            if (it->second >= size)
+            size_t offset = it->first, blockSize = it->second;
+            eraseFreeBlock(it);
+            if (blockSize > size)
             {
-                size_t offset = it->first;
-                if (it->second > size)
-                {
-                    freeBlocks[it->first + size] = it->second - size;
-                }
-                freeBlocks.erase(it);
-                used += size;
-                return offset;
+                insertFreeBlock(offset + size, blockSize - size);
             }
+            used += size;
+            return offset;
         }
 
-        size_t offset = used;
-        used += size;
-        if (used > peak)
+        // No free block is large enough: grow the arena at its end. `used`
+        // cannot serve as the end offset once blocks have been freed, and a
+        // free block touching the end is extended instead of left behind.
+        size_t offset = peak;
+        if (!freeBlocks.empty())
         {
-            peak = used;
+            auto last = std::prev(freeBlocks.end());
+            if (last->first + last->second == peak)
+            {
+                offset = last->first;
+                eraseFreeBlock(last);
+            }
         }
+        used += size;
+        peak = offset + size;
         return offset;
     }
 
@@ -71,17 +79,78 @@ namespace infini
             if (prev->first + prev->second == start)
             {
                 start = prev->first;
-                freeBlocks.erase(prev);
+                eraseFreeBlock(prev);
             }
         }
 
         if (it != freeBlocks.end() && it->first == end)
         {
             end = it->first + it->second;
-            freeBlocks.erase(it);
+            eraseFreeBlock(it);
+        }
+
+        insertFreeBlock(start, end - start);
+    }
+
+    std::map<size_t, size_t>::iterator Allocator::findFreeBlock(size_t size)
+    {
+        switch (policy)
+        {
+        case AllocPolicy::FirstFit:
+            for (auto it = freeBlocks.begin(); it != freeBlocks.end(); ++it)
+            {
+                if (it->second >= size)
+                {
+                    return it;
+                }
+            }
+            return freeBlocks.end();
+        case AllocPolicy::BestFit:
+        {
+            auto it = freeBlocksBySize.lower_bound({size, 0});
+            if (it == freeBlocksBySize.end())
+            {
+                return freeBlocks.end();
+            }
+            return freeBlocks.find(it->second);
         }
+        case AllocPolicy::WorstFit:
+        {
+            if (freeBlocksBySize.empty() ||
+                freeBlocksBySize.rbegin()->first < size)
+            {
+                return freeBlocks.end();
+            }
+            return freeBlocks.find(freeBlocksBySize.rbegin()->second);
+        }
+        default:
+            IT_TODO_HALT();
+        }
+    }
 
-        freeBlocks[start] = end - start;
+    void Allocator::insertFreeBlock(size_t addr, size_t size)
+    {
+        freeBlocks[addr] = size;
+        freeBlocksBySize.emplace(size, addr);
+    }
+
+    void Allocator::eraseFreeBlock(std::map<size_t, size_t>::iterator it)
+    {
+        freeBlocksBySize.erase({it->second, it->first});
+        freeBlocks.erase(it);
+    }
+
+    void Allocator::reset()
+    {
+        if (this->ptr != nullptr)
+        {
+            runtime->dealloc(this->ptr);
+            this->ptr = nullptr;
+        }
+        used = 0;
+        peak = 0;
+        freeBlocks.clear();
+        freeBlocksBySize.clear();
     }
 
     void *Allocator::getPtr()
@@ -101,7 +170,10 @@ namespace infini
 
     void Allocator::info()
     {
+        static const char *policyNames[] = {"first-fit", "best-fit",
+                                            "worst-fit"};
         std::cout << "Used memory: " << this->used
-                  << ", peak memory: " << this->peak << std::endl;
+                  << ", peak memory: " << this->peak << " ("
+                  << policyNames[static_cast<int>(policy)] << ")" << std::endl;
     }
 }
@@ -0,0 +1,162 @@
+#include "core/batch_scheduler.h"
+#include "core/graph.h"
+#include "core/runtime.h"
+#include <cstring>
+
+namespace infini
+{
+    BatchSchedulerObj::BatchSchedulerObj(const GraphBuilder &build,
+                                         const Graph &reference,
+                                         const TensorVec &inputs,
+                                         size_t maxBatch,
+                                         std::chrono::microseconds maxDelay)
+        : build(build), reference(reference),
+          maxBatch(std::max<size_t>(1, maxBatch)), maxDelay(maxDelay)
+    {
+        const auto &tensors = reference->getTensors();
+        for (auto &input : inputs)
+        {
+            auto it = std::find(tensors.begin(), tensors.end(), input);
+            IT_ASSERT(it != tensors.end(),
+                      "BatchScheduler: inputs must belong to the reference graph.");
+            inputIndex.emplace_back(it - tensors.begin());
+        }
+        dispatcher = std::thread([this]
+                                 { loop(); });
+    }
+
+    BatchSchedulerObj::~BatchSchedulerObj()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            stopping = true;
+        }
+        requestQueued.notify_one();
+        dispatcher.join();
+    }
+
+    std::future<void>
+    BatchSchedulerObj::submit(const vector<const void *> &inputData,
+                              const vector<void *> &outputData)
+    {
+        IT_ASSERT(inputData.size() == inputIndex.size() &&
+                      outputData.size() == reference->getOutputs().size(),
+                  "BatchScheduler: wrong number of input or output buffers.");
+        Request request{inputData, outputData, {}};
+        auto future = request.done.get_future();
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            queue.emplace_back(std::chrono::steady_clock::now(),
+                               std::move(request));
+        }
+        requestQueued.notify_one();
+        return future;
+    }
+
+    void BatchSchedulerObj::loop()
+    {
+        while (true)
+        {
+            vector<Request> requests;
+            {
+                std::unique_lock<std::mutex> lock(mutex);
+                requestQueued.wait(lock, [&]
+                                   { return stopping || !queue.empty(); });
+                if (queue.empty())
+                    return;
+                // 等到凑满一批，或最早的请求用完了它的延迟预算
+                requestQueued.wait_until(lock, queue.front().first + maxDelay,
+                                         [&]
+                                         { return stopping ||
+                                                  queue.size() >= maxBatch; });
+                while (!queue.empty() && requests.size() < maxBatch)
+                {
+                    requests.emplace_back(std::move(queue.front().second));
+                    queue.pop_front();
+                }
+            }
+            runBatch(requests);
+        }
+    }
+
+    BatchSchedulerObj::Batch &BatchSchedulerObj::getBatch(size_t size)
+    {
+        if (auto it = batches.find(size); it != batches.end())
+            return it->second;
+
+        // 每种批大小只构建、推导形状和规划内存一次。新图不调用 dataMalloc：
+        // 权重按在 getTensors() 中的位置绑定到参考图的权重上，并检查形状和
+        // 类型一致，其余张量放在上下文中
+        Graph graph = reference;
+        if (size > 1)
+        {
+            graph = build(size);
+            graph->shape_infer();
+        }
+        const auto &tensors = graph->getTensors(),
+                   &referenceTensors = reference->getTensors();
+        IT_ASSERT(tensors.size() == referenceTensors.size(),
+                  "BatchScheduler: graphs of different batch sizes differ.");
+        std::unordered_set<size_t> requestInputs(inputIndex.begin(),
+                                                 inputIndex.end());
+        unordered_map<TensorObj *, Tensor> weights;
+        for (size_t i = 0; i < tensors.size(); ++i)
+        {
+            if (tensors[i]->getSource() || requestInputs.count(i))
+                continue;
+            const auto &weight = referenceTensors[i];
+            IT_ASSERT(!weight->getSource() &&
+                          weight->getDims() == tensors[i]->getDims() &&
+                          weight->getDType() == tensors[i]->getDType(),
+                      "BatchScheduler: weight " + std::to_string(i) +
+                          " does not match the reference graph's.");
+            weights.emplace(tensors[i].get(), weight);
+        }
+
+        Batch batch;
+        for (auto i : inputIndex)
+            batch.inputs.emplace_back(tensors[i]);
+        batch.outputs = graph->getOutputs();
+        batch.model = make_ref<CompiledModelObj>(
+            graph, batch.inputs, [weights](const Tensor &tensor)
+            { return tensorData(weights.at(tensor.get())); });
+        batch.context = make_ref<ExecutionContextObj>(batch.model);
+        return batches.emplace(size, std::move(batch)).first->second;
+    }
+
+    void BatchSchedulerObj::runBatch(vector<Request> &requests)
+    {
+        const size_t n = requests.size();
+        try
+        {
+            auto &batch = getBatch(n);
+            const auto &context = batch.context;
+            // 输入按第一维依次拼接，输出按第一维切开还给各个请求
+            for (size_t i = 0; i < batch.inputs.size(); ++i)
+            {
+                auto data = static_cast<char *>(context->getData(batch.inputs[i]));
+                const size_t bytes = batch.inputs[i]->getBytes() / n;
+                for (size_t r = 0; r < n; ++r)
+                    std::memcpy(data + r * bytes, requests[r].inputs[i], bytes);
+            }
+            context->run();
+            for (size_t i = 0; i < batch.outputs.size(); ++i)
+            {
+                auto data = static_cast<const char *>(
+                    context->getData(batch.outputs[i]));
+                const size_t bytes = batch.outputs[i]->getBytes() / n;
+                for (size_t r = 0; r < n; ++r)
+                    std::memcpy(requests[r].outputs[i], data + r * bytes, bytes);
+            }
+        }
+        catch (...)
+        {
+            for (auto &request : requests)
+                request.done.set_exception(std::current_exception());
+            return;
+        }
+        for (auto &request : requests)
+            request.done.set_value();
+    }
+
+} // namespace infini
@@ -0,0 +1,61 @@
+#include "core/compiled_model.h"
+#include "core/runtime.h"
+
+namespace infini
+{
+    CompiledModelObj::CompiledModelObj(const Graph &graph,
+                                       const TensorVec &inputs,
+                                       const DataBinding &weights)
+        : graph(graph), inputs(inputs), weights(weights)
+    {
+        // 每个上下文私有的张量：指定的输入和所有计算得到的张量；其余的图
+        // 输入是共享的权重，不占上下文的空间
+        std::unordered_set<TensorObj *> varying;
+        for (auto &input : inputs)
+        {
+            IT_ASSERT(!input->getSource(),
+                      "CompiledModel: inputs must be graph inputs.");
+            varying.insert(input.get());
+        }
+        TensorVec shared;
+        for (auto &tensor : graph->getTensors())
+            if (!tensor->getSource() && !varying.count(tensor.get()))
+                shared.emplace_back(tensor);
+
+        // 上下文的内存单独规划，保留张量复用和零拷贝 Concat
+        MemoryPlan plan = graph->planMemory(shared);
+        const auto &tensors = graph->getTensors();
+        for (size_t i = 0; i < tensors.size(); ++i)
+            if (tensors[i]->getSource() || varying.count(tensors[i].get()))
+                offsets.emplace(tensors[i].get(), plan.offsets[i]);
+        arenaSize = plan.peak;
+    }
+
+    void *CompiledModelObj::getData(const Tensor &tensor, void *arena) const
+    {
+        auto it = offsets.find(tensor.get());
+        if (it == offsets.end())
+            return weights(tensor);
+        return static_cast<char *>(arena) + it->second;
+    }
+
+    ExecutionContextObj::ExecutionContextObj(const CompiledModel &model)
+        : model(model),
+          arena(model->getGraph()->getRuntime()->alloc(model->getArenaSize()))
+    {
+        plan = make_ref<ExecutionPlanObj>(
+            model->getGraph(), [this](const Tensor &tensor)
+            { return getData(tensor); });
+    }
+
+    ExecutionContextObj::~ExecutionContextObj()
+    {
+        model->getGraph()->getRuntime()->dealloc(arena);
+    }
+
+    void ExecutionContextObj::run() const
+    {
+        model->getGraph()->getRuntime()->run(*plan);
+    }
+
+} // namespace infini
@@ -0,0 +1,165 @@
+#include "core/execution_plan.h"
+#include <exception>
+#include <mutex>
+
+namespace infini
+{
+    ExecutionPlanObj::ExecutionPlanObj(const Graph &graph,
+                                       const DataBinding &data)
+        : ExecutionPlanObj(*graph, data)
+    {
+        this->graph = graph;
+    }
+
+    ExecutionPlanObj::ExecutionPlanObj(GraphObj &graph, const DataBinding &data)
+        : runtime(graph.getRuntime())
+    {
+        const auto &kernelRegistry = KernelRegistry::getInstance();
+        const Device device = runtime->getDevice();
+        steps.reserve(graph.getOperators().size());
+        for (auto &op : graph.getOperators())
+        {
+            // 优先使用自动调优选出的内核，否则按数据类型查找默认内核
+            const Kernel *kernel = op->getKernel();
+            if (!kernel)
+                kernel = kernelRegistry.getKernel(KernelAttrs{
+                    device, op->getOpType().underlying(), op->getDType()});
+            steps.push_back({kernel, kernel->prepare(op, data), {}, 0});
+        }
+
+        // 依赖关系：读取其他步骤输出的步骤依赖该步骤；另外 dataMalloc 会让
+        // 生命周期不重叠的张量共用内存，因此访问的内存有重叠、且至少一方写
+        // 入的两个步骤也必须保持原有顺序
+        struct Access
+        {
+            uintptr_t begin, end;
+            size_t step;
+            bool write;
+        };
+        vector<Access> live;
+        unordered_map<OperatorObj *, size_t> index;
+        for (auto &op : graph.getOperators())
+            index.emplace(op.get(), index.size());
+        for (auto &op : graph.getOperators())
+        {
+            const size_t i = index.at(op.get());
+            std::set<size_t> predecessors;
+            for (auto &input : op->getInputs())
+                if (auto source = input->getSource())
+                    if (auto it = index.find(source.get()); it != index.end())
+                        predecessors.insert(it->second);
+
+            vector<Access> accesses;
+            auto addAccess = [&](const Tensor &tensor, bool write)
+            {
+                auto begin = reinterpret_cast<uintptr_t>(data(tensor));
+                if (tensor->getBytes() > 0)
+                    accesses.push_back(
+                        {begin, begin + tensor->getBytes(), i, write});
+            };
+            for (auto &input : op->getInputs())
+                addAccess(input, false);
+            for (auto &output : op->getOutputs())
+                addAccess(output, true);
+            for (auto &earlier : live)
+                for (auto &access : accesses)
+                    if ((earlier.write || access.write) &&
+                        earlier.begin < access.end && access.begin < earlier.end)
+                        predecessors.insert(earlier.step);
+
+            // 被本步骤写入完全覆盖的旧访问不再需要：之后与它冲突的步骤
+            // 必然也与本步骤冲突，从而间接排在它之后
+            live.erase(std::remove_if(live.begin(), live.end(),
+                                      [&](const Access &earlier)
+                                      {
+                                          return std::any_of(
+                                              accesses.begin(), accesses.end(),
+                                              [&](const Access &access)
+                                              {
+                                                  return access.write &&
+                                                         access.begin <= earlier.begin &&
+                                                         earlier.end <= access.end;
+                                              });
+                                      }),
+                       live.end());
+            live.insert(live.end(), accesses.begin(), accesses.end());
+
+            for (auto p : predecessors)
+                steps[p].successors.emplace_back(i);
+            steps[i].nPredecessors = predecessors.size();
+        }
+    }
+
+    void ExecutionPlanObj::run() const
+    {
+        const RuntimeObj *context = runtime.get();
+        for (auto &step : steps)
+            step.kernel->run(*step.state, context);
+    }
+
+    void ExecutionPlanObj::run(ThreadPool &pool, size_t maxConcurrent) const
+    {
+        const RuntimeObj *context = runtime.get();
+        // 依赖都已完成的步骤先进入 ready，同时运行的步骤不超过 maxConcurrent
+        std::mutex mutex;
+        vector<size_t> waiting(steps.size()), ready;
+        size_t active = 0;
+        std::atomic<size_t> remaining(steps.size());
+        // 出错后不再执行后续步骤，但仍释放依赖，保证等待能够结束
+        std::atomic<bool> failed(false);
+        std::exception_ptr error;
+
+        std::function<void(size_t)> execute;
+        // 调用时需持有 mutex
+        auto launch = [&]
+        {
+            while (active < maxConcurrent && !ready.empty())
+            {
+                const size_t i = ready.back();
+                ready.pop_back();
+                ++active;
+                pool.submit([&execute, i]
+                            { execute(i); });
+            }
+        };
+        execute = [&](size_t i)
+        {
+            if (!failed)
+            {
+                try
+                {
+                    steps[i].kernel->run(*steps[i].state, context);
+                }
+                catch (...)
+                {
+                    if (!failed.exchange(true))
+                        error = std::current_exception();
+                }
+            }
+            {
+                std::lock_guard<std::mutex> lock(mutex);
+                --active;
+                for (auto next : steps[i].successors)
+                    if (--waiting[next] == 0)
+                        ready.emplace_back(next);
+                launch();
+            }
+            --remaining;
+        };
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            for (size_t i = steps.size(); i-- > 0;)
+            {
+                waiting[i] = steps[i].nPredecessors;
+                if (waiting[i] == 0)
+                    ready.emplace_back(i);
+            }
+            launch();
+        }
+        pool.waitUntil([&]
+                       { return remaining == 0; });
+        if (error)
+            std::rethrow_exception(error);
+    }
+
+} // namespace infini
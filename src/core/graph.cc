@@ -1,7 +1,10 @@
 #include "core/graph.h"
 #include "operators/transpose.h"
 #include "operators/matmul.h"
+#include "operators/concat.h"
 #include "core/common.h"
+#include "core/execution_plan.h"
+#include "core/memory_planner.h"
 #include <algorithm>
 #include <numeric>
 #include <queue>
@@ -12,7 +15,11 @@ namespace infini
     void GraphObj::addOperatorAndConnect(const Operator &op)
     {
         sorted = false;
-        ops.push_back(op);
+        executionPlan.reset();
+        // 被删除但尚未擦除的算子仍在 ops 中，重新加入时不再追加
+        if (!removedOps.erase(op.get()))
+            ops.push_back(op);
+        opIndex.emplace(op->getGuid(), op);
         for (auto &input : op->getInputs())
         {
             if (input)
@@ -39,8 +46,94 @@ namespace infini
         }
     }
 
+    void GraphObj::removeOperator(const Operator &op)
+    {
+        auto it = opIndex.find(op->getGuid());
+        if (it == opIndex.end() || it->second != op)
+            return;
+        opIndex.erase(it);
+        removedOps.insert(op.get());
+        executionPlan.reset();
+    }
+
+    void GraphObj::removeTensor(const Tensor &tensor)
+    {
+        auto it = tensorIndex.find(tensor->getFuid());
+        if (it == tensorIndex.end() || it->second != tensor)
+            return;
+        tensorIndex.erase(it);
+        removedTensors.insert(tensor.get());
+    }
+
+    bool GraphObj::hasOperator(const Operator &op) const
+    {
+        auto it = opIndex.find(op->getGuid());
+        return it != opIndex.end() && it->second == op;
+    }
+
+    bool GraphObj::hasTensor(const Tensor &tensor) const
+    {
+        auto it = tensorIndex.find(tensor->getFuid());
+        return it != tensorIndex.end() && it->second == tensor;
+    }
+
+    void GraphObj::compact() const
+    {
+        // 一次线性扫描擦除全部已删除的元素，其余元素的相对顺序不变
+        if (!removedTensors.empty())
+        {
+            tensors.erase(std::remove_if(tensors.begin(), tensors.end(),
+                                         [this](const Tensor &tensor)
+                                         { return removedTensors.count(tensor.get()); }),
+                          tensors.end());
+            removedTensors.clear();
+        }
+        if (!removedOps.empty())
+        {
+            ops.erase(std::remove_if(ops.begin(), ops.end(),
+                                     [this](const Operator &op)
+                                     { return removedOps.count(op.get()); }),
+                      ops.end());
+            removedOps.clear();
+        }
+    }
+
+    void GraphObj::reconnect()
+    {
+        sorted = false;
+        executionPlan.reset();
+        compact();
+        tensorIndex.clear();
+        opIndex.clear();
+        for (auto &tensor : tensors)
+        {
+            tensorIndex.emplace(tensor->getFuid(), tensor);
+            tensor->clearTargets();
+            tensor->setSource(nullptr);
+        }
+        for (auto &op : ops)
+        {
+            opIndex.emplace(op->getGuid(), op);
+            op->predecessors.clear();
+            op->successors.clear();
+            for (auto &output : op->getOutputs())
+                output->setSource(op);
+        }
+        for (auto &op : ops)
+            for (auto &input : op->getInputs())
+            {
+                input->addTarget(op);
+                if (auto pred = input->getSource())
+                {
+                    pred->addSuccessors(op);
+                    op->addPredecessors(pred);
+                }
+            }
+    }
+
     string GraphObj::toString() const
     {
+        compact();
         std::ostringstream oss;
         oss << "Graph Tensors:\n";
         for (const auto &tensor : tensors)
@@ -64,42 +157,50 @@ namespace infini
 
     bool GraphObj::topo_sort()
     {
+        compact();
         if (this->sorted)
         {
             return true;
         }
+        // Kahn 算法：算子的入度为其输入中有源算子的个数。每次取出就绪算子中
+        // 原位置最靠前的一个，因此已经有序的部分保持原来的顺序
+        unordered_map<OperatorObj *, size_t> position;
+        position.reserve(ops.size());
+        for (size_t i = 0; i < ops.size(); ++i)
+            position.emplace(ops[i].get(), i);
+        vector<size_t> inDegree(ops.size(), 0);
+        vector<vector<size_t>> consumers(ops.size());
+        for (size_t i = 0; i < ops.size(); ++i)
+            for (auto &input : ops[i]->getInputs())
+                if (auto source = input ? input->getSource() : nullptr)
+                {
+                    // 源算子不在图中时入度永远不会减到 0，排序失败
+                    ++inDegree[i];
+                    if (auto it = position.find(source.get()); it != position.end())
+                        consumers[it->second].emplace_back(i);
+                }
+
+        std::priority_queue<size_t, vector<size_t>, std::greater<size_t>> ready;
+        for (size_t i = 0; i < ops.size(); ++i)
+            if (inDegree[i] == 0)
+                ready.push(i);
         std::vector<Operator> sorted;
-        std::unordered_set<OperatorObj *> flags;
         sorted.reserve(ops.size());
-        flags.reserve(ops.size());
-        while (sorted.size() < ops.size())
+        while (!ready.empty())
         {
-            // Any node is move to sorted in this loop.
-            auto modified = false;
-            for (auto const &op : ops)
-            {
-                if (auto const &inputs = op->getInputs();
-                    flags.find(op.get()) == flags.end() &&
-                    std::all_of(inputs.begin(), inputs.end(),
-                                [&flags](auto const &input)
-                                {
-                                    auto ptr = input->getSource().get();
-                                    return !ptr || flags.find(ptr) != flags.end();
-                                }))
-                // 该算子不在flag中，且该算子的所有输入的源算子在flag中
-                // 则将该算子加入sorted中
-                {
-                    modified = true;
-                    sorted.emplace_back(op);
-                    flags.insert(op.get());
-                }
-            }
-            if (!modified)
-            {
-                return false;
-            }
+            auto i = ready.top();
+            ready.pop();
+            sorted.emplace_back(ops[i]);
+            for (auto consumer : consumers[i])
+                if (--inDegree[consumer] == 0)
+                    ready.push(consumer);
+        }
+        if (sorted.size() < ops.size())
+        {
+            return false;
         }
         this->ops = std::move(sorted);
+        executionPlan.reset();
         return this->sorted = true;
     }
 
@@ -110,200 +211,101 @@ namespace infini
         // 图优化规则如下：
         //1. 去除冗余的算子（例如，两个相邻的算子都是 transpose 算子，且做的是相反的操作，可以将其全部删除）
         //2. 合并算子（例如，矩阵乘算子中含有属性transA、transB，如果其输入存在transpose，且对最后两个维度做交换，就可以将transpose融入到矩阵乘算子的属性中去）
-        bool modified = true;
+        // 按拓扑序扫描，规则只沿输入张量查看上游的源算子。删除的算子和张量
+        // 先从索引中去掉，扫描结束后一次性擦除并重建连接关系
+        IT_ASSERT(topo_sort() == true);
+        bool modified = true, changed = false;
         while (modified)
         {
             modified = false;
-            for (int i = 0; i < (int)ops.size(); ++i)
+            for (size_t i = 0; i < ops.size(); ++i)
             {
                 auto op = ops[i];
-                
-                // 规则1: 去除冗余的相邻 Transpose 算子
-                if (i + 1 < (int)ops.size() &&
-                    op->getOpType() == OpType::Transpose &&
-                    ops[i + 1]->getOpType() == OpType::Transpose)
+                if (!hasOperator(op))
+                    continue;
+
+                // 规则1: 去除冗余的相邻 Transpose 算子，要求中间张量只被第二个
+                // Transpose 使用，且结果有后继
+                if (op->getOpType() == OpType::Transpose)
                 {
-                    auto transpose1 = as<TransposeObj>(op);
-                    auto transpose2 = as<TransposeObj>(ops[i + 1]);
-                    
-                    auto permute1 = transpose1->getPermute();
-                    auto permute2 = transpose2->getPermute();
-
-                    // 检查是否为相反的操作
-                    bool isOpposite = true;
-                    for (size_t j = 0; j < permute1.size(); ++j)
+                    auto transpose2 = as<TransposeObj>(op);
+                    auto output1 = transpose2->getInputs(0);
+                    auto output2 = transpose2->getOutput();
+                    auto source = output1->getSource();
+                    if (source && source->getOpType() == OpType::Transpose &&
+                        output1->getTargets().size() == 1 &&
+                        !output2->getTargets().empty())
                     {
-                        if (static_cast<size_t>(permute2[permute1[j]]) != j)
-                        {
-                            isOpposite = false;
-                            break;
-                        }
-                    }
-                    
-                    if (isOpposite)
-                    {
-                         // 获取两个 Transpose 算子的输出张量
-                        auto output1 = transpose1->getOutputs()[0];
-                        auto output2 = transpose2->getOutputs()[0];
-                        
-                        // 获取第一个 Transpose 的输入张量
-                        auto input1 = transpose1->getInputs()[0];
-                        
-                        // 更新后继操作符的输入
-                        auto successors = transpose2->getSuccessors();
-                        for (auto &succ : successors)
-                        {
-                            auto succInputs = succ->getInputs();
-                            for (size_t j = 0; j < succInputs.size(); ++j)
-                            {
-                                if (succInputs[j] == output2)
-                                {
-                                    succ->inputs[j] = input1;
-                                    break;
-                                }
-                            }
-                        }
-                        
-                        for (auto &succ : transpose1->getSuccessors())
-                        {
-                            succ->removePredecessors(transpose1);
-                        }
-                        for (auto &pred : transpose1->getPredecessors())
-                        {
-                            pred->removeSuccessors(transpose1);
-                        }
-                        for (auto &succ : transpose2->getSuccessors())
-                        {
-                            succ->removePredecessors(transpose2);
-                        }
-                        for (auto &pred : transpose2->getPredecessors())
-                        {
-                            pred->removeSuccessors(transpose2);
-                        }
-                        
-                        // 移除两个 Transpose 算子
-                        ops.erase(ops.begin() + i + 1);
-                        ops.erase(ops.begin() + i);
-                        
-                        // 移除中间张量
-                        removeTensor(output1);
-                        removeTensor(output2);
-                        
-                        // 更新张量的连接关系
-                        input1->removeTarget(transpose1);
-                        for (auto &succ : successors)
+                        auto transpose1 = as<TransposeObj>(source);
+                        auto permute1 = transpose1->getPermute();
+                        auto permute2 = transpose2->getPermute();
+
+                        // 检查是否为相反的操作
+                        bool isOpposite = permute1.size() == permute2.size();
+                        for (size_t j = 0; isOpposite && j < permute1.size(); ++j)
+                            isOpposite = static_cast<size_t>(permute2[permute1[j]]) == j;
+
+                        if (isOpposite)
                         {
-                            input1->addTarget(succ);
+                            // 后继直接读取第一个 Transpose 的输入
+                            auto input1 = transpose1->getInputs(0);
+                            input1->removeTarget(transpose1);
+                            for (auto &succ : output2->getTargets())
+                                for (auto &input : succ->inputs)
+                                    if (input == output2)
+                                    {
+                                        input = input1;
+                                        input1->addTarget(succ);
+                                    }
+
+                            // 移除两个 Transpose 算子和中间张量
+                            removeOperator(transpose1);
+                            removeOperator(transpose2);
+                            removeTensor(output1);
+                            removeTensor(output2);
+                            modified = changed = true;
+                            continue;
                         }
-                        
-                        --i;
-                        modified = true;
-                        continue;
                     }
                 }
-                
-                // 规则2: 将 Transpose 合并到 Matmul
+
+                // 规则2: 将只交换最后两维、且只被 Matmul 使用的 Transpose 合并
+                // 到 Matmul 的 transA / transB 中
                 if (op->getOpType() == OpType::MatMul)
                 {
                     auto matmul = as<MatmulObj>(op);
-                    auto inputs = matmul->getInputs();
-                    
-                    // 检查第一个输入是否为 Transpose
-                    if (inputs[0] && inputs[0]->getSource())
+                    for (int k = 0; k < 2; ++k)
                     {
-                        auto source = inputs[0]->getSource();
-                        if (source->getOpType() == OpType::Transpose)
-                        {
-                            auto transpose = as<TransposeObj>(source);
-                            if (isSwapLastTwoDims(transpose.get()))
-                            {
-                                // 获取 Transpose 的输出张量
-                                auto transposeOutput = transpose->getOutputs()[0];
-
-                                // 将 Transpose 的效果融入到 Matmul 的 transA 中
-                                bool newTransA = !matmul->getTransA();
-                                matmul->setTransA(newTransA);
-                                
-                                // 更新 Matmul 的输入为 Transpose 的输入
-                                auto transposeInput = transpose->getInputs()[0];
-                                matmul->inputs[0] = transposeInput;
-                                
-                                // 清理predecessors和successors引用
-                                for (auto &succ : transpose->getSuccessors())
-                                {
-                                    succ->removePredecessors(transpose);
-                                }
-                                for (auto &pred : transpose->getPredecessors())
-                                {
-                                    pred->removeSuccessors(transpose);
-                                }
-                                
-                                // 移除 Transpose 算子
-                                removeOperator(transpose);
-                                
-                                // 移除中间张量
-                                removeTensor(transposeOutput);
-                                
-                                // 更新张量的连接关系
-                                transposeInput->removeTarget(transpose);
-                                transposeInput->addTarget(matmul);
-                                
-                                --i;
-                                modified = true;
-                                continue;
-                            }
-                        }
-                    }
-                    
-                    // 检查第二个输入是否为 Transpose
-                    if (inputs[1] && inputs[1]->getSource())
-                    {
-                        auto source = inputs[1]->getSource();
-                        if (source->getOpType() == OpType::Transpose)
-                        {
-                            auto transpose = as<TransposeObj>(source);
-                            if (isSwapLastTwoDims(transpose.get()))
-                            {
-                                // 获取 Transpose 的输出张量
-                                auto transposeOutput = transpose->getOutputs()[0];
-                                
-                                // 将 Transpose 的效果融入到 Matmul 的 transB 中
-                                bool newTransB = !matmul->getTransB();
-                                matmul->setTransB(newTransB);
-                                
-                                // 更新 Matmul 的输入为 Transpose 的输入
-                                auto transposeInput = transpose->getInputs()[0];
-                                matmul->inputs[1] = transposeInput;
-                                
-                                // 清理predecessors和successors引用
-                                for (auto &succ : transpose->getSuccessors())
-                                {
-                                    succ->removePredecessors(transpose);
-                                }
-                                for (auto &pred : transpose->getPredecessors())
-                                {
-                                    pred->removeSuccessors(transpose);
-                                }
-                                
-                                // 移除 Transpose 算子
-                                removeOperator(transpose);
-                                
-                                // 移除中间张量
-                                removeTensor(transposeOutput);
-                                
-                                // 更新张量的连接关系
-                                transposeInput->removeTarget(transpose);
-                                transposeInput->addTarget(matmul);
-                                
-                                --i;
-                                modified = true;
-                                continue;
-                            }
-                        }
+                        auto transposeOutput = matmul->getInputs(k);
+                        auto source = transposeOutput->getSource();
+                        if (!source || source->getOpType() != OpType::Transpose ||
+                            transposeOutput->getTargets().size() != 1)
+                            continue;
+                        auto transpose = as<TransposeObj>(source);
+                        if (!isSwapLastTwoDims(transpose.get()))
+                            continue;
+
+                        if (k == 0)
+                            matmul->setTransA(!matmul->getTransA());
+                        else
+                            matmul->setTransB(!matmul->getTransB());
+
+                        // 更新 Matmul 的输入为 Transpose 的输入
+                        auto transposeInput = transpose->getInputs(0);
+                        matmul->inputs[k] = transposeInput;
+                        transposeInput->removeTarget(transpose);
+                        transposeInput->addTarget(matmul);
+
+                        // 移除 Transpose 算子和中间张量
+                        removeOperator(transpose);
+                        removeTensor(transposeOutput);
+                        modified = changed = true;
                     }
                 }
             }
         }
+        if (changed)
+            reconnect();
         // =================================== 作业 ===================================
     }
 
@@ -341,18 +343,14 @@ namespace infini
 
     Tensor GraphObj::getTensor(int fuid) const
     {
-        for (auto tensor : tensors)
-        {
-            if (tensor->getFuid() == fuid)
-            {
-                return tensor;
-            }
-        }
-        return nullptr;
+        auto it = tensorIndex.find(fuid);
+        return it == tensorIndex.end() ? nullptr : it->second;
     }
 
     void GraphObj::shape_infer()
     {
+        compact();
+        executionPlan.reset();
         for (auto &op : ops)
         {
             auto ans = op->inferShape();
@@ -374,42 +372,243 @@ namespace infini
         }
     }
 
-    void GraphObj::dataMalloc()
+    GraphObj::BufferLayout
+    GraphObj::layoutBuffers(const std::function<size_t(const Tensor &)> &bytes,
+                            const TensorVec &external)
     {
         // topological sorting first
         IT_ASSERT(topo_sort() == true);
 
+        std::unordered_map<OperatorObj *, size_t> opIndex;
+        for (size_t i = 0; i < ops.size(); ++i)
+            opIndex[ops[i].get()] = i;
+        // 并行执行时（runtime 的 inter-op 线程数大于 1）改用算子在依赖图中
+        // 的层次作为时间：同一层的算子可能同时运行，它们的张量不能共用内存
+        if (runtime->getInterOpThreads() > 1)
+            for (auto &op : ops)
+            {
+                size_t level = 0;
+                for (auto &input : op->getInputs())
+                    if (auto source = input->getSource())
+                        level = std::max(level, opIndex.at(source.get()) + 1);
+                opIndex[op.get()] = level;
+            }
+        std::unordered_map<TensorObj *, size_t> tensorIndex;
+        for (size_t i = 0; i < tensors.size(); ++i)
+            tensorIndex[tensors[i].get()] = i;
+        vector<bool> isExternal(tensors.size(), false);
+        for (auto &tensor : external)
+            isExternal[tensorIndex.at(tensor.get())] = true;
+
+        // 1. 零拷贝 Concat：若拼接轴之前的维度都为 1，则每个输入恰好是输出中
+        //    一段连续的切片，可以直接把输入放在输出内存中的对应偏移处，
+        //    Concat 运行时发现输入已在原位便跳过拷贝。
+        //    aliasOf[i] 为张量 i 所在的张量，aliasOffset[i] 为其中的字节偏移。
+        vector<size_t> aliasOf(tensors.size()), aliasOffset(tensors.size(), 0);
+        std::iota(aliasOf.begin(), aliasOf.end(), 0);
+        for (auto &op : ops)
+        {
+            if (op->getOpType() != OpType::Concat)
+                continue;
+            auto concat = as<ConcatObj>(op);
+            auto output = concat->getOutput();
+            auto outDim = output->getDims();
+            int axis = concat->getDim();
+            if (!std::all_of(outDim.begin(), outDim.begin() + axis,
+                             [](int d)
+                             { return d == 1; }))
+                continue;
+            size_t outIdx = tensorIndex.at(output.get()), offset = 0;
+            if (isExternal[outIdx])
+                continue;
+            for (auto &input : concat->getInputs())
+            {
+                size_t inIdx = tensorIndex.at(input.get());
+                // 每个张量只能放在一个位置：已被其他 Concat 吸收、或在同一个
+                // Concat 中重复出现的输入仍然走拷贝；外部张量留在原处
+                if (aliasOf[inIdx] == inIdx && inIdx != outIdx &&
+                    !isExternal[inIdx])
+                {
+                    aliasOf[inIdx] = outIdx;
+                    aliasOffset[inIdx] = offset;
+                }
+                offset += bytes(input);
+            }
+        }
+        // 沿着嵌套的 Concat 找到最终持有内存的张量，并累加偏移
+        auto resolve = [&](size_t i)
+        {
+            size_t offset = 0;
+            while (aliasOf[i] != i)
+            {
+                offset += aliasOffset[i];
+                i = aliasOf[i];
+            }
+            return std::make_pair(i, offset);
+        };
+
+        // 2. 统计每个张量的生命周期：由定义它的算子开始，到最后一个使用它的
+        //    算子结束。图的输入从头驻留，图的输出一直驻留到执行结束。
+        //    放在其他张量内部的张量把生命周期合并进持有内存的张量。
+        size_t lastStep = ops.empty() ? 0 : ops.size() - 1;
+        vector<TensorLifetime> lifetimes;
+        lifetimes.reserve(tensors.size());
+        for (auto &tensor : tensors)
+        {
+            auto source = tensor->getSource();
+            auto targets = tensor->getTargets();
+            TensorLifetime lifetime{bytes(tensor), 0, lastStep};
+            if (source)
+                lifetime.first = opIndex.at(source.get());
+            if (source && !targets.empty())
+            {
+                lifetime.last = lifetime.first;
+                for (auto &target : targets)
+                    lifetime.last = std::max(lifetime.last, opIndex.at(target.get()));
+            }
+            lifetimes.emplace_back(lifetime);
+        }
+        vector<size_t> owners, planIndex(tensors.size(), BufferLayout::none);
+        for (size_t i = 0; i < tensors.size(); ++i)
+            if (aliasOf[i] == i && !isExternal[i])
+            {
+                planIndex[i] = owners.size();
+                owners.emplace_back(i);
+            }
+        vector<TensorLifetime> ownerLifetimes;
+        ownerLifetimes.reserve(owners.size());
+        for (auto i : owners)
+            ownerLifetimes.emplace_back(lifetimes[i]);
+        for (size_t i = 0; i < tensors.size(); ++i)
+        {
+            if (isExternal[i])
+                continue;
+            auto &owner = ownerLifetimes[planIndex[resolve(i).first]];
+            owner.first = std::min(owner.first, lifetimes[i].first);
+            owner.last = std::max(owner.last, lifetimes[i].last);
+        }
+
+        BufferLayout layout{std::move(ownerLifetimes), vector<size_t>(tensors.size()),
+                            vector<size_t>(tensors.size())};
+        for (size_t i = 0; i < tensors.size(); ++i)
+        {
+            auto [owner, innerOffset] = resolve(i);
+            layout.buffers[i] = planIndex[owner];
+            layout.offsets[i] = innerOffset;
+        }
+        return layout;
+    }
+
+    MemoryPlan GraphObj::planMemory(const TensorVec &external)
+    {
+        compact();
+        for (auto &tensor : tensors)
+            IT_ASSERT(!isSymbolic(tensor->getDims()),
+                      "Symbolic shapes need planParametricMemory.");
+        auto layout = layoutBuffers([](const Tensor &tensor)
+                                    { return tensor->getBytes(); },
+                                    external);
+
+        // 3. 离线规划每个张量在内存池中的偏移量，取多种策略中峰值最小者
+        MemoryPlan plan = MemoryPlanner(runtime).plan(layout.lifetimes, allocator.getPolicy());
+        vector<size_t> offsets(tensors.size(), 0);
+        for (size_t i = 0; i < tensors.size(); ++i)
+            if (layout.buffers[i] != BufferLayout::none)
+                offsets[i] = plan.offsets[layout.buffers[i]] + layout.offsets[i];
+        plan.offsets = std::move(offsets);
+        return plan;
+    }
+
+    ParametricMemoryPlan GraphObj::planParametricMemory(ShapeElem symbol,
+                                                        const TensorVec &external)
+    {
+        // 含符号维度的张量按每单位 n 的字节数规划，其余张量按实际字节数；
+        // 同一个缓冲区中的张量要么都含该符号，要么都不含
+        auto bytes = [&](const Tensor &tensor)
+        {
+            size_t size = tensor->getDType().getSize();
+            int occurrences = 0;
+            for (auto dim : tensor->getDims())
+            {
+                if (dim == symbol)
+                    ++occurrences;
+                else
+                {
+                    IT_ASSERT(!isSymbolic(dim),
+                              "Only one symbolic dimension can be planned for.");
+                    size *= dim;
+                }
+            }
+            IT_ASSERT(occurrences <= 1,
+                      "Tensor sizes must be linear in the symbolic dimension.");
+            return size;
+        };
+        auto hasSymbol = [&](size_t i)
+        {
+            auto dims = tensors[i]->getDims();
+            return std::find(dims.begin(), dims.end(), symbol) != dims.end();
+        };
+        auto layout = layoutBuffers(bytes, external);
+        vector<bool> scaled(layout.lifetimes.size(), false);
+        for (size_t i = 0; i < tensors.size(); ++i)
+            if (layout.buffers[i] != BufferLayout::none && hasSymbol(i))
+                scaled[layout.buffers[i]] = true;
+        for (size_t i = 0; i < tensors.size(); ++i)
+            IT_ASSERT(layout.buffers[i] == BufferLayout::none ||
+                      scaled[layout.buffers[i]] == hasSymbol(i));
+
+        auto plan = MemoryPlanner(runtime).planParametric(
+            layout.lifetimes, scaled, allocator.getPolicy());
+        ParametricMemoryPlan result{vector<size_t>(tensors.size()),
+                                    vector<size_t>(tensors.size()), plan.peak,
+                                    plan.peakScale};
+        // 张量在缓冲区内的偏移与缓冲区本身同样按 n 缩放或固定
+        for (size_t i = 0; i < tensors.size(); ++i)
+        {
+            const size_t buffer = layout.buffers[i];
+            if (buffer == BufferLayout::none)
+                continue;
+            result.offsets[i] = plan.offsets[buffer];
+            result.scales[i] = plan.scales[buffer];
+            if (scaled[buffer])
+                result.scales[i] += layout.offsets[i];
+            else
+                result.offsets[i] += layout.offsets[i];
+        }
+        return result;
+    }
+
+    void GraphObj::dataMalloc()
+    {
+        // 重新分配时释放旧的内存池，所有张量都会重新绑定
+        executionPlan.reset();
+        allocator.reset();
+
         // =================================== 作业 ===================================
         // TODO：利用 allocator 给计算图分配内存
         // HINT: 获取分配好的内存指针后，可以调用 tensor 的 setDataBlob 函数给 tensor 绑定内存
         // =================================== 作业 ===================================
 
-        // 1. 为所有张量分配内存，记录偏移量
-        std::map<Tensor, size_t> tensorOffsets;
-        for (auto tensor : tensors)
-        {
-            size_t offset = allocator.alloc(tensor->getBytes());
-            tensorOffsets[tensor] = offset;
-        }
-
-        // 2. 获取实际分配的内存指针
-        void *basePtr = allocator.getPtr();
+        MemoryPlan plan = planMemory();
+        size_t base = allocator.alloc(plan.peak);
+        void *basePtr = static_cast<char *>(allocator.getPtr()) + base;
 
-        // 3. 为每个张量创建 Blob 并绑定内存
-        for (auto tensor : tensors)
+        // 4. 为每个张量创建 Blob 并绑定内存
+        for (size_t i = 0; i < tensors.size(); ++i)
         {
-            size_t offset = tensorOffsets[tensor];
-            void *tensorPtr = static_cast<char *>(basePtr) + offset;
+            auto &tensor = tensors[i];
+            void *tensorPtr = static_cast<char *>(basePtr) + plan.offsets[i];
             Blob blob = make_ref<BlobObj>(runtime, tensorPtr);
             tensor->setDataBlob(blob);
         }
 
+        plan.info();
         allocator.info();
     }
 
     Tensor GraphObj::addTensor(Shape dim, DataType dtype)
     {
-        return tensors.emplace_back(make_ref<TensorObj>(dim, dtype, runtime));
+        return addTensor(make_ref<TensorObj>(dim, dtype, runtime));
     }
 
     Tensor GraphObj::addTensor(const Tensor &tensor)
@@ -418,7 +617,9 @@ namespace infini
                   std::string("Tensor runtime mismatch: cannot add a tenosr in ") +
                       tensor->getRuntime()->toString() + " to " +
                       runtime->toString());
-        tensors.emplace_back(tensor);
+        if (!removedTensors.erase(tensor.get()))
+            tensors.emplace_back(tensor);
+        tensorIndex.emplace(tensor->getFuid(), tensor);
         return tensor;
     }
 
@@ -429,51 +630,58 @@ namespace infini
         return tensors;
     }
 
+    const ExecutionPlanObj &GraphObj::getExecutionPlan()
+    {
+        // 缓存的计划不持有图，否则两者互相引用而无法释放
+        if (!executionPlan)
+            executionPlan.reset(new ExecutionPlanObj(*this, tensorData));
+        return *executionPlan;
+    }
+
     // tensor's "source" and "target" must be in "ops".
     // tensor has no "source" and no "target" must not exist.
     // "inputs" or "outputs" of operators must be in "tensors"
     // "predecessors" and "successors" of an operator of "ops" must be in "ops".
     bool GraphObj::checkValid() const
     {
+        compact();
         for (auto tensor : tensors)
         {
             IT_ASSERT(!(tensor->getTargets().size() == 0 &&
                         nullptr == tensor->getSource()));
             for (auto op : tensor->getTargets())
             {
-                IT_ASSERT(std::find(ops.begin(), ops.end(), op) != ops.end());
+                IT_ASSERT(hasOperator(op));
             }
             auto op = tensor->getSource();
-            IT_ASSERT(!(op && std::find(ops.begin(), ops.end(), op) == ops.end()));
+            IT_ASSERT(!(op && !hasOperator(op)));
         }
         for (auto op : ops)
         {
             for (auto tensor : op->getInputs())
             {
-                IT_ASSERT(std::find(tensors.begin(), tensors.end(), tensor) !=
-                          tensors.end());
+                IT_ASSERT(hasTensor(tensor));
             }
             for (auto tensor : op->getOutputs())
             {
-                IT_ASSERT(std::find(tensors.begin(), tensors.end(), tensor) !=
-                          tensors.end());
+                IT_ASSERT(hasTensor(tensor));
             }
             for (auto pre : op->getPredecessors())
             {
-                IT_ASSERT(std::find(ops.begin(), ops.end(), pre) != ops.end());
+                IT_ASSERT(hasOperator(pre));
             }
             for (auto suc : op->getSuccessors())
             {
-                IT_ASSERT(std::find(ops.begin(), ops.end(), suc) != ops.end());
+                IT_ASSERT(hasOperator(suc));
             }
         }
-        std::set<UidBaseType> s;
+        std::unordered_set<UidBaseType> s;
+        s.reserve(tensors.size());
         // check whether two tensors with the same FUID exist
         for (auto tensor : tensors)
         {
-            int cnt = s.count(tensor->getFuid());
-            IT_ASSERT(cnt == 0, std::to_string(tensor->getFuid()));
-            s.insert(tensor->getFuid());
+            IT_ASSERT(s.insert(tensor->getFuid()).second,
+                      std::to_string(tensor->getFuid()));
         }
         return true;
     }
@@ -0,0 +1,232 @@
+#include "core/memory_planner.h"
+#include <algorithm>
+#include <limits>
+#include <numeric>
+
+namespace infini
+{
+    MemoryPlanner::MemoryPlanner(Runtime runtime) : runtime(runtime)
+    {
+        // keep the same alignment as Allocator so plans are interchangeable
+        alignment = sizeof(uint64_t);
+    }
+
+    size_t MemoryPlanner::getAlignedSize(size_t size) const
+    {
+        return (size + alignment - 1) / alignment * alignment;
+    }
+
+    size_t MemoryPlanner::lowerBound(const vector<TensorLifetime> &lifetimes) const
+    {
+        size_t steps = 0;
+        for (auto &t : lifetimes)
+            steps = std::max(steps, t.last + 1);
+        // difference array over steps: +size at first, -size after last
+        vector<long long> delta(steps + 1, 0);
+        for (auto &t : lifetimes)
+        {
+            delta[t.first] += getAlignedSize(t.size);
+            delta[t.last + 1] -= getAlignedSize(t.size);
+        }
+        long long live = 0, maxLive = 0;
+        for (size_t s = 0; s < steps; ++s)
+        {
+            live += delta[s];
+            maxLive = std::max(maxLive, live);
+        }
+        return maxLive;
+    }
+
+    MemoryPlan MemoryPlanner::plan(const vector<TensorLifetime> &lifetimes,
+                                   AllocPolicy policy) const
+    {
+        MemoryPlan best = planOnline(lifetimes, policy);
+        for (auto candidate :
+             {planGreedyBySize(lifetimes), planGreedyByBreadth(lifetimes)})
+        {
+            if (candidate.peak < best.peak)
+                best = std::move(candidate);
+        }
+        return best;
+    }
+
+    ParametricMemoryPlan
+    MemoryPlanner::planParametric(const vector<TensorLifetime> &lifetimes,
+                                  const vector<bool> &scaled,
+                                  AllocPolicy policy) const
+    {
+        // 一个放得下每单位 n 大小的方案放大 n 倍后仍然有效，因此两组分开规划：
+        // 按 n 缩放的缓冲区占据前 peakScale * n 字节，固定大小的放在其后
+        vector<TensorLifetime> groups[2];
+        vector<size_t> indexInGroup(lifetimes.size());
+        for (size_t i = 0; i < lifetimes.size(); ++i)
+        {
+            indexInGroup[i] = groups[scaled[i]].size();
+            groups[scaled[i]].emplace_back(lifetimes[i]);
+        }
+        MemoryPlan fixed = plan(groups[0], policy), perUnit = plan(groups[1], policy);
+
+        ParametricMemoryPlan result{vector<size_t>(lifetimes.size()),
+                                    vector<size_t>(lifetimes.size()), fixed.peak,
+                                    perUnit.peak};
+        for (size_t i = 0; i < lifetimes.size(); ++i)
+        {
+            if (scaled[i])
+                result.scales[i] = perUnit.offsets[indexInGroup[i]];
+            else
+            {
+                result.offsets[i] = fixed.offsets[indexInGroup[i]];
+                result.scales[i] = perUnit.peak;
+            }
+        }
+        return result;
+    }
+
+    MemoryPlan ParametricMemoryPlan::instantiate(size_t n) const
+    {
+        MemoryPlan plan{"parametric", vector<size_t>(offsets.size()),
+                        peak + peakScale * n, 0};
+        for (size_t i = 0; i < offsets.size(); ++i)
+            plan.offsets[i] = offsets[i] + scales[i] * n;
+        return plan;
+    }
+
+    MemoryPlan MemoryPlanner::planOnline(const vector<TensorLifetime> &lifetimes,
+                                         AllocPolicy policy) const
+    {
+        static const char *names[] = {"online-first-fit", "online-best-fit",
+                                      "online-worst-fit"};
+        MemoryPlan plan{names[static_cast<int>(policy)],
+                        vector<size_t>(lifetimes.size()), 0,
+                        lowerBound(lifetimes)};
+        vector<size_t> byFirst(lifetimes.size()), byLast(lifetimes.size());
+        std::iota(byFirst.begin(), byFirst.end(), 0);
+        std::iota(byLast.begin(), byLast.end(), 0);
+        std::stable_sort(byFirst.begin(), byFirst.end(), [&](size_t a, size_t b)
+                         { return lifetimes[a].first < lifetimes[b].first; });
+        std::stable_sort(byLast.begin(), byLast.end(), [&](size_t a, size_t b)
+                         { return lifetimes[a].last < lifetimes[b].last; });
+
+        // at every step, allocate what the op defines before releasing what
+        // it consumed for the last time
+        Allocator allocator(runtime, policy);
+        auto def = byFirst.begin(), kill = byLast.begin();
+        while (def != byFirst.end() || kill != byLast.end())
+        {
+            if (def != byFirst.end() &&
+                (kill == byLast.end() ||
+                 lifetimes[*def].first <= lifetimes[*kill].last))
+            {
+                plan.offsets[*def] = allocator.alloc(lifetimes[*def].size);
+                ++def;
+            }
+            else
+            {
+                allocator.free(plan.offsets[*kill], lifetimes[*kill].size);
+                ++kill;
+            }
+        }
+        plan.peak = allocator.getPeak();
+        return plan;
+    }
+
+    MemoryPlan MemoryPlanner::placeInOrder(const vector<TensorLifetime> &lifetimes,
+                                           const vector<size_t> &order) const
+    {
+        MemoryPlan plan{"", vector<size_t>(lifetimes.size()), 0,
+                        lowerBound(lifetimes)};
+        // already placed buffers, kept sorted by offset
+        vector<size_t> placed;
+        placed.reserve(lifetimes.size());
+        for (auto i : order)
+        {
+            const auto &t = lifetimes[i];
+            size_t size = getAlignedSize(t.size);
+            // find the tightest gap between placed buffers that are live at
+            // the same time as t
+            size_t prevEnd = 0, bestOffset = 0;
+            size_t bestGap = std::numeric_limits<size_t>::max();
+            bool found = false;
+            for (auto j : placed)
+            {
+                const auto &u = lifetimes[j];
+                if (u.last < t.first || t.last < u.first)
+                    continue;
+                size_t offset = plan.offsets[j];
+                if (offset >= prevEnd + size && offset - prevEnd < bestGap)
+                {
+                    bestGap = offset - prevEnd;
+                    bestOffset = prevEnd;
+                    found = true;
+                }
+                prevEnd = std::max(prevEnd, offset + getAlignedSize(u.size));
+            }
+            plan.offsets[i] = found ? bestOffset : prevEnd;
+            plan.peak = std::max(plan.peak, plan.offsets[i] + size);
+            auto pos = std::upper_bound(
+                placed.begin(), placed.end(), plan.offsets[i],
+                [&](size_t offset, size_t j)
+                { return offset < plan.offsets[j]; });
+            placed.insert(pos, i);
+        }
+        return plan;
+    }
+
+    MemoryPlan
+    MemoryPlanner::planGreedyBySize(const vector<TensorLifetime> &lifetimes) const
+    {
+        vector<size_t> order(lifetimes.size());
+        std::iota(order.begin(), order.end(), 0);
+        std::stable_sort(order.begin(), order.end(), [&](size_t a, size_t b)
+                         { return lifetimes[a].size > lifetimes[b].size; });
+        auto plan = placeInOrder(lifetimes, order);
+        plan.strategy = "greedy-by-size";
+        return plan;
+    }
+
+    MemoryPlan
+    MemoryPlanner::planGreedyByBreadth(const vector<TensorLifetime> &lifetimes) const
+    {
+        size_t steps = 0;
+        for (auto &t : lifetimes)
+            steps = std::max(steps, t.last + 1);
+        vector<vector<size_t>> liveAt(steps);
+        vector<size_t> breadth(steps, 0);
+        for (size_t i = 0; i < lifetimes.size(); ++i)
+            for (size_t s = lifetimes[i].first; s <= lifetimes[i].last; ++s)
+            {
+                liveAt[s].emplace_back(i);
+                breadth[s] += getAlignedSize(lifetimes[i].size);
+            }
+        vector<size_t> stepOrder(steps);
+        std::iota(stepOrder.begin(), stepOrder.end(), 0);
+        std::stable_sort(stepOrder.begin(), stepOrder.end(),
+                         [&](size_t a, size_t b)
+                         { return breadth[a] > breadth[b]; });
+
+        vector<size_t> order;
+        order.reserve(lifetimes.size());
+        vector<bool> visited(lifetimes.size(), false);
+        for (auto s : stepOrder)
+        {
+            auto &live = liveAt[s];
+            std::stable_sort(live.begin(), live.end(), [&](size_t a, size_t b)
+                             { return lifetimes[a].size > lifetimes[b].size; });
+            for (auto i : live)
+                if (!visited[i])
+                {
+                    visited[i] = true;
+                    order.emplace_back(i);
+                }
+        }
+        auto plan = placeInOrder(lifetimes, order);
+        plan.strategy = "greedy-by-breadth";
+        return plan;
+    }
+
+    void MemoryPlan::info() const
+    {
+        std::cout << "Memory plan (" << strategy << "): peak memory: " << peak
+                  << ", lower bound: " << lowerBound << std::endl;
+    }
+} // namespace infini
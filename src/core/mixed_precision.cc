@@ -0,0 +1,170 @@
+#include "core/graph.h"
+#include "operators/unary.h"
+#include "utils/half.h"
+#include <cstring>
+
+namespace infini
+{
+    namespace
+    {
+        // Ops whose half kernels compute in float and only store 16-bit
+        // results; they are worth lowering on their own.
+        bool isAllowed(OpType type)
+        {
+            switch (type.underlying())
+            {
+            case OpType::MatMul:
+            case OpType::Add:
+            case OpType::Sub:
+            case OpType::Mul:
+            case OpType::Div:
+                return true;
+            default:
+                return false;
+            }
+        }
+
+        // Ops that are exact in any precision; they follow their inputs and
+        // run in half only when an input is already half.
+        bool isFollower(OpType type)
+        {
+            switch (type.underlying())
+            {
+            case OpType::Relu:
+            case OpType::Clip:
+            case OpType::Transpose:
+            case OpType::Concat:
+                return true;
+            default:
+                return false;
+            }
+        }
+    } // namespace
+
+    void GraphObj::mixedPrecision(const TensorVec &inputs, DataType dtype)
+    {
+        IT_ASSERT(dtype == DataType::Float16 || dtype == DataType::BFloat16,
+                  "mixedPrecision: dtype must be Float16 or BFloat16.");
+        IT_ASSERT(topo_sort() == true);
+        const CastType narrow = dtype == DataType::Float16
+                                    ? CastType::Float2Float16
+                                    : CastType::Float2BFloat16;
+        const CastType widen = dtype == DataType::Float16
+                                   ? CastType::Float162Float
+                                   : CastType::BFloat162Float;
+
+        // 不在 inputs 中的图输入视为常量权重，重新分配内存前先保存
+        std::unordered_set<TensorObj *> fed;
+        for (auto &tensor : inputs)
+            fed.insert(tensor.get());
+        auto isWeight = [&](const Tensor &tensor)
+        { return !tensor->getSource() && !fed.count(tensor.get()); };
+        unordered_map<TensorObj *, vector<char>> saved;
+        for (auto &tensor : tensors)
+            if (isWeight(tensor))
+            {
+                auto data = tensor->getRawDataPtr<char *>();
+                saved.emplace(tensor.get(),
+                              vector<char>(data, data + tensor->getBytes()));
+            }
+
+        // 1. 按拓扑序决定哪些算子降为半精度：允许列表中的算子总是降，
+        //    跟随类算子只在已有半精度输入时降；输入必须都是 Float32
+        std::unordered_set<TensorObj *> halfTensors;
+        std::unordered_set<OperatorObj *> lowered;
+        for (auto &op : ops)
+        {
+            auto inputs = op->getInputs();
+            if (!std::all_of(inputs.begin(), inputs.end(), [](const Tensor &t)
+                             { return t->getDType() == DataType::Float32; }))
+                continue;
+            bool lower = isAllowed(op->getOpType()) ||
+                         (isFollower(op->getOpType()) &&
+                          std::any_of(inputs.begin(), inputs.end(),
+                                      [&](const Tensor &t)
+                                      { return halfTensors.count(t.get()); }));
+            if (!lower)
+                continue;
+            lowered.insert(op.get());
+            for (auto &output : op->getOutputs())
+                halfTensors.insert(output.get());
+        }
+
+        // 2. 改写：降精度算子的输出换成半精度张量；仍被 Float32 算子使用
+        //    或作为图输出的张量由 Cast 转回原张量，Float32 激活在第一次
+        //    被半精度算子使用前转换一次，权重则换成数据只转换一次的半精度
+        //    张量，运行时不再读取浮点权重
+        unordered_map<TensorObj *, Tensor> halfOf;
+        auto needsFloat = [&](const Tensor &tensor)
+        {
+            auto targets = tensor->getTargets();
+            return targets.empty() ||
+                   std::any_of(targets.begin(), targets.end(),
+                               [&](const Operator &target)
+                               { return !lowered.count(target.get()); });
+        };
+        OpVec rewritten;
+        TensorVec dropped;
+        vector<pair<Tensor, Tensor>> halfWeights;
+        for (auto &op : ops)
+        {
+            if (!lowered.count(op.get()))
+            {
+                rewritten.emplace_back(op);
+                continue;
+            }
+            for (auto &input : op->inputs)
+            {
+                Tensor &half = halfOf[input.get()];
+                if (!half && isWeight(input))
+                {
+                    half = addTensor(input->getDims(), dtype);
+                    halfWeights.emplace_back(half, input);
+                }
+                else if (!half)
+                {
+                    auto cast = make_ref<CastObj>(this, input, nullptr, narrow);
+                    rewritten.emplace_back(cast);
+                    half = cast->getOutput();
+                }
+                input = half;
+            }
+            rewritten.emplace_back(op);
+            for (auto &output : op->outputs)
+            {
+                auto half = addTensor(output->getDims(), dtype);
+                halfOf[output.get()] = half;
+                if (needsFloat(output))
+                    rewritten.emplace_back(
+                        make_ref<CastObj>(nullptr, half, output, widen));
+                else
+                    dropped.emplace_back(output);
+                output = half;
+            }
+            IT_ASSERT(op->inferDataType() == vector<DataType>(op->numOutputs(), dtype));
+        }
+        ops = std::move(rewritten);
+        for (auto &tensor : dropped)
+            removeTensor(tensor);
+        reconnect();
+        for (auto &[half, weight] : halfWeights)
+            if (weight->getTargets().empty())
+                removeTensor(weight);
+
+        // 3. 重新推导形状并检查图的连接关系
+        shape_infer();
+        IT_ASSERT(checkValid());
+
+        // 4. 重新分配内存，恢复权重并写入转换后的半精度权重
+        dataMalloc();
+        for (auto &tensor : getTensors())
+            if (auto it = saved.find(tensor.get()); it != saved.end())
+                std::memcpy(tensor->getRawDataPtr<void *>(), it->second.data(),
+                            it->second.size());
+        for (auto &[half, weight] : halfWeights)
+            floatToHalf(dtype,
+                        reinterpret_cast<const float *>(saved.at(weight.get()).data()),
+                        half->getRawDataPtr<uint16_t *>(), half->size());
+    }
+
+} // namespace infini
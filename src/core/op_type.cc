@@ -21,6 +21,9 @@ namespace infini
             CASE(Transpose);
             CASE(Concat);
             CASE(MatMul);
+            CASE(QuantizedMatMul);
+            CASE(QuantizeLinear);
+            CASE(DequantizeLinear);
 
         default:
             return "Unknown";
@@ -0,0 +1,205 @@
+#include "core/plan_cache.h"
+#include "core/runtime.h"
+
+namespace infini
+{
+    PlanCacheObj::PlanCacheObj(const Graph &graph, const TensorVec &inputs,
+                               size_t capacity,
+                               const vector<Shape> &symbolicInputShapes)
+        : graph(graph), inputs(inputs), capacity(std::max<size_t>(1, capacity))
+    {
+        for (auto &input : inputs)
+            IT_ASSERT(!input->getSource(),
+                      "PlanCache: inputs must be graph inputs.");
+        const auto &tensors = graph->getTensors();
+        for (size_t i = 0; i < tensors.size(); ++i)
+        {
+            tensorIndex.emplace(tensors[i].get(), i);
+            if (!tensors[i]->getSource() &&
+                std::find(inputs.begin(), inputs.end(), tensors[i]) == inputs.end())
+                weights.emplace_back(tensors[i]);
+        }
+        if (symbolicInputShapes.empty())
+            return;
+
+        IT_ASSERT(symbolicInputShapes.size() == inputs.size(),
+                  "PlanCache: one shape per input expected.");
+        for (auto &shape : symbolicInputShapes)
+            for (auto dim : shape)
+                if (isSymbolic(dim))
+                {
+                    IT_ASSERT(symbol == 0 || symbol == dim,
+                              "PlanCache: only one symbolic dimension is supported.");
+                    symbol = dim;
+                }
+        IT_ASSERT(symbol != 0, "PlanCache: no symbolic dimension given.");
+        withShapes(symbolicInputShapes, [&]
+                   {
+                       for (auto &tensor : tensors)
+                           symbolicShapes.emplace_back(tensor->getDims());
+                       parametricPlan = graph->planParametricMemory(symbol, weights); });
+    }
+
+    PlanCacheObj::~PlanCacheObj()
+    {
+        for (auto &entry : entries)
+            graph->getRuntime()->dealloc(entry.arena);
+    }
+
+    void PlanCacheObj::withShapes(const vector<Shape> &inputShapes,
+                                  const std::function<void()> &fn)
+    {
+        const auto &tensors = graph->getTensors();
+        vector<Shape> saved;
+        saved.reserve(tensors.size());
+        for (auto &tensor : tensors)
+            saved.emplace_back(tensor->getDims());
+        // 算子在 shape_infer 中记下的尺寸（如 MatMul 的 m、n、k）也要恢复，
+        // 否则图自己运行时会按试探的形状准备内核
+        auto restore = [&]
+        {
+            for (size_t i = 0; i < tensors.size(); ++i)
+                tensors[i]->setShape(saved[i]);
+            graph->shape_infer();
+        };
+        try
+        {
+            for (size_t i = 0; i < inputs.size(); ++i)
+                inputs[i]->setShape(inputShapes[i]);
+            graph->shape_infer();
+            fn();
+        }
+        catch (...)
+        {
+            restore();
+            throw;
+        }
+        restore();
+    }
+
+    ShapeElem PlanCacheObj::matchSymbol() const
+    {
+        if (symbol == 0)
+            return 0;
+        // 符号维度在输入中取到的值，要求处处相同
+        ShapeElem value = 0;
+        for (auto &input : inputs)
+        {
+            const auto &shape = symbolicShapes[tensorIndex.at(input.get())];
+            const auto &dims = input->getDims();
+            if (dims.size() != shape.size())
+                return 0;
+            for (size_t j = 0; j < dims.size(); ++j)
+                if (shape[j] == symbol && (value == 0 || value == dims[j]))
+                    value = dims[j];
+                else if (shape[j] != dims[j])
+                    return 0;
+        }
+        if (value <= 0)
+            return 0;
+        // 参数化的规划只在所有张量的形状都是符号形状代入该值时有效
+        const auto &tensors = graph->getTensors();
+        for (size_t i = 0; i < tensors.size(); ++i)
+            if (substitute(symbolicShapes[i], symbol, value) !=
+                tensors[i]->getDims())
+                return 0;
+        return value;
+    }
+
+    PlanCacheObj::Entry PlanCacheObj::build(const vector<Shape> &inputShapes)
+    {
+        // 在图上临时换成新的形状，规划内存并准备内核。权重仍在图的内存中，
+        // 不占条目的 arena
+        Entry entry{inputShapes, {}, {}, nullptr, nullptr};
+        withShapes(inputShapes, [&]
+                   {
+                       MemoryPlan plan;
+                       if (auto value = matchSymbol())
+                       {
+                           plan = parametricPlan.instantiate(value);
+                           ++instantiations;
+                       }
+                       else
+                           plan = graph->planMemory(weights);
+                       entry.offsets = std::move(plan.offsets);
+                       entry.arena = graph->getRuntime()->alloc(plan.peak);
+                       try
+                       {
+                           prepare(entry);
+                       }
+                       catch (...)
+                       {
+                           graph->getRuntime()->dealloc(entry.arena);
+                           throw;
+                       } });
+        return entry;
+    }
+
+    void PlanCacheObj::prepare(Entry &entry) const
+    {
+        std::unordered_set<TensorObj *> varying;
+        for (auto &input : inputs)
+            varying.insert(input.get());
+        auto arena = static_cast<char *>(entry.arena);
+        entry.plan = make_ref<ExecutionPlanObj>(
+            graph, [&](const Tensor &tensor) -> void *
+            {
+                if (!tensor->getSource() && !varying.count(tensor.get()))
+                    return tensorData(tensor);
+                return arena + entry.offsets[tensorIndex.at(tensor.get())];
+            });
+        for (auto &tensor : graph->getTensors())
+            entry.shapes.emplace_back(tensor->getDims());
+    }
+
+    bool PlanCacheObj::select(const vector<Shape> &inputShapes)
+    {
+        IT_ASSERT(inputShapes.size() == inputs.size(),
+                  "PlanCache: one shape per input expected.");
+        if (auto it = index.find(inputShapes); it != index.end())
+        {
+            entries.splice(entries.begin(), entries, it->second);
+            ++hits;
+            return true;
+        }
+
+        ++misses;
+        entries.emplace_front(build(inputShapes));
+        index.emplace(inputShapes, entries.begin());
+        if (entries.size() > capacity)
+        {
+            auto &evicted = entries.back();
+            graph->getRuntime()->dealloc(evicted.arena);
+            index.erase(evicted.key);
+            entries.pop_back();
+        }
+        return false;
+    }
+
+    const PlanCacheObj::Entry &PlanCacheObj::current() const
+    {
+        IT_ASSERT(!entries.empty(), "PlanCache: no shapes selected.");
+        return entries.front();
+    }
+
+    void *PlanCacheObj::getData(const Tensor &tensor) const
+    {
+        auto &entry = current();
+        const size_t i = tensorIndex.at(tensor.get());
+        if (!tensor->getSource() &&
+            std::find(inputs.begin(), inputs.end(), tensor) == inputs.end())
+            return tensorData(tensor);
+        return static_cast<char *>(entry.arena) + entry.offsets[i];
+    }
+
+    const Shape &PlanCacheObj::getDims(const Tensor &tensor) const
+    {
+        return current().shapes[tensorIndex.at(tensor.get())];
+    }
+
+    void PlanCacheObj::run() const
+    {
+        graph->getRuntime()->run(*current().plan);
+    }
+
+} // namespace infini
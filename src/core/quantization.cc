@@ -0,0 +1,299 @@
+#include "core/execution_plan.h"
+#include "core/graph.h"
+#include "operators/matmul.h"
+#include "operators/quantized_matmul.h"
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+namespace infini
+{
+    namespace
+    {
+        // Copy one calibration sample into the graph inputs it feeds.
+        void feed(const CalibrationSample &sample)
+        {
+            for (auto &[tensor, data] : sample)
+            {
+                IT_ASSERT(tensor->getDType() == DataType::Float32 &&
+                              data.size() == tensor->size(),
+                          "quantize: calibration data does not match its tensor.");
+                std::memcpy(tensor->getRawDataPtr<void *>(), data.data(),
+                            tensor->getBytes());
+            }
+        }
+
+        // A weight holds a single matrix if all its batch dimensions are 1.
+        bool isMatrix(const Tensor &weight)
+        {
+            auto dims = weight->getDims();
+            return dims.size() >= 2 &&
+                   std::all_of(dims.begin(), dims.end() - 2, [](int d)
+                               { return d == 1; });
+        }
+
+        // Symmetric int8 quantization of a [k, n] ([n, k] if transposed)
+        // weight matrix with one scale per output channel.
+        QuantParams quantizeWeight(const Tensor &weight, bool trans,
+                                   vector<int8_t> &q)
+        {
+            auto dims = weight->getDims();
+            const int rank = dims.size();
+            const int k = trans ? dims[rank - 1] : dims[rank - 2];
+            const int n = trans ? dims[rank - 2] : dims[rank - 1];
+            const size_t row = trans ? 1 : n, col = trans ? k : 1;
+            const float *w = weight->getRawDataPtr<float *>();
+            vector<float> scale(n);
+            q.resize(weight->size());
+            for (int j = 0; j < n; ++j)
+            {
+                float amax = 0.f;
+                for (int p = 0; p < k; ++p)
+                    amax = std::max(amax, std::abs(w[p * row + j * col]));
+                scale[j] = amax > 0.f ? amax / 127.f : 1.f;
+                for (int p = 0; p < k; ++p)
+                {
+                    const size_t i = p * row + j * col;
+                    q[i] = int8_t(std::min(
+                        127.f, std::max(-127.f, std::nearbyint(w[i] / scale[j]))));
+                }
+            }
+            return QuantParams(std::move(scale), vector<int>(n, 0));
+        }
+    } // namespace
+
+    void QuantizationReport::info() const
+    {
+        std::cout << "Quantization: " << quantizedOps
+                  << " MatMul quantized, " << foldedPairs
+                  << " Q/DQ pairs folded, output SQNR (dB): " << vecToString(sqnr)
+                  << std::endl;
+    }
+
+    QuantizationReport GraphObj::quantize(const vector<CalibrationSample> &calibration)
+    {
+        IT_ASSERT(!calibration.empty(), "quantize: no calibration samples.");
+        IT_ASSERT(topo_sort() == true);
+        const Graph self = shared_from_this();
+
+        // 没有被校准数据喂入的图输入视为常量权重，重新分配内存前先保存
+        std::unordered_set<TensorObj *> fed;
+        for (auto &[tensor, data] : calibration[0])
+            fed.insert(tensor.get());
+        auto isWeight = [&](const Tensor &tensor)
+        { return !tensor->getSource() && !fed.count(tensor.get()); };
+        vector<pair<Tensor, vector<char>>> saved;
+        for (auto &tensor : tensors)
+            if (isWeight(tensor))
+            {
+                auto data = tensor->getRawDataPtr<char *>();
+                saved.emplace_back(tensor,
+                                   vector<char>(data, data + tensor->getBytes()));
+            }
+
+        // 1. 校准：逐个样本运行浮点图，记录每个 Float32 张量的取值范围，
+        //    并保存图输出作为精度对比的参考
+        unordered_map<TensorObj *, TensorRange> ranges;
+        TensorVec outputs;
+        for (auto &tensor : getOutputs())
+            if (tensor->getDType() == DataType::Float32)
+                outputs.emplace_back(tensor);
+        vector<vector<float>> reference(outputs.size());
+        //    dataMalloc 让生命周期不重叠的中间张量共用内存，运行结束时只剩最后
+        //    写入者的数据，因此校准时每个计算出的张量使用独立的缓冲区
+        unordered_map<TensorObj *, vector<uint64_t>> activations;
+        for (auto &tensor : tensors)
+            if (tensor->getSource())
+                activations[tensor.get()].resize(
+                    (tensor->getBytes() + sizeof(uint64_t) - 1) / sizeof(uint64_t));
+        auto calibrationData = [&](const Tensor &tensor) -> void *
+        {
+            auto it = activations.find(tensor.get());
+            return it == activations.end() ? tensorData(tensor)
+                                           : it->second.data();
+        };
+        ExecutionPlanObj calibrationPlan(self, calibrationData);
+        for (auto &sample : calibration)
+        {
+            feed(sample);
+            runtime->run(calibrationPlan);
+            for (auto &tensor : tensors)
+            {
+                if (!(tensor->getDType() == DataType::Float32) || tensor->size() == 0)
+                    continue;
+                auto data = static_cast<float *>(calibrationData(tensor));
+                auto [lo, hi] = std::minmax_element(data, data + tensor->size());
+                auto it = ranges.find(tensor.get());
+                if (it == ranges.end())
+                    ranges.emplace(tensor.get(), TensorRange{*lo, *hi});
+                else
+                {
+                    it->second.min = std::min(it->second.min, *lo);
+                    it->second.max = std::max(it->second.max, *hi);
+                }
+            }
+            for (size_t i = 0; i < outputs.size(); ++i)
+            {
+                auto data = static_cast<float *>(calibrationData(outputs[i]));
+                reference[i].insert(reference[i].end(), data,
+                                    data + outputs[i]->size());
+            }
+        }
+        auto rangeParams = [&](const Tensor &tensor)
+        {
+            auto range = ranges.at(tensor.get());
+            return QuantParams::fromRange(range.min, range.max);
+        };
+
+        // 2. 改写：B 为权重的 MatMul 换成 QuantizeLinear -> QuantizedMatMul
+        //    -> DequantizeLinear，原输出张量保持不变。同一张量只量化一次。
+        unordered_map<TensorObj *, Tensor> quantizedInputs;
+        map<pair<TensorObj *, bool>, pair<Tensor, QuantParams>> quantizedWeights;
+        vector<pair<Tensor, vector<int8_t>>> weightData;
+        TensorVec replacedWeights;
+        OpVec rewritten;
+        size_t quantizedOps = 0;
+        for (auto &op : ops)
+        {
+            rewritten.emplace_back(op);
+            if (op->getOpType() != OpType::MatMul)
+                continue;
+            auto matmul = as<MatmulObj>(op);
+            auto A = matmul->getInputs(0), B = matmul->getInputs(1);
+            auto C = matmul->getOutput();
+            if (matmul->getTransA() || !(A->getDType() == DataType::Float32) ||
+                !(B->getDType() == DataType::Float32) || !isMatrix(B) ||
+                !isWeight(B) || isWeight(A))
+                continue;
+            rewritten.pop_back();
+
+            auto aParams = rangeParams(A);
+            Tensor &aq = quantizedInputs[A.get()];
+            if (!aq)
+            {
+                auto quantize = make_ref<QuantizeLinearObj>(this, A, nullptr, aParams);
+                rewritten.emplace_back(quantize);
+                aq = quantize->getOutput();
+            }
+            bool transB = matmul->getTransB();
+            auto it = quantizedWeights.find({B.get(), transB});
+            if (it == quantizedWeights.end())
+            {
+                vector<int8_t> data;
+                auto bParams = quantizeWeight(B, transB, data);
+                auto dims = B->getDims();
+                auto bq = addTensor(Shape(dims.end() - 2, dims.end()), DataType::Int8);
+                weightData.emplace_back(bq, std::move(data));
+                replacedWeights.emplace_back(B);
+                it = quantizedWeights.emplace(std::make_pair(B.get(), transB),
+                                              std::make_pair(bq, bParams))
+                         .first;
+            }
+            auto [bq, bParams] = it->second;
+            auto cParams = rangeParams(C);
+            auto qmm = make_ref<QuantizedMatmulObj>(this, aq, bq, nullptr, aParams,
+                                                    bParams, cParams, transB);
+            rewritten.emplace_back(qmm);
+            rewritten.emplace_back(make_ref<DequantizeLinearObj>(
+                nullptr, qmm->getOutput(), C, cParams));
+            ++quantizedOps;
+        }
+        ops = std::move(rewritten);
+        reconnect();
+        for (auto &weight : replacedWeights)
+            if (weight->getTargets().empty())
+                removeTensor(weight);
+
+        // 3. 折叠：DequantizeLinear 的输出若只被参数相同的 QuantizeLinear
+        //    使用，两者都可去掉，后继直接读取量化张量
+        std::unordered_set<OperatorObj *> removed;
+        size_t foldedPairs = 0;
+        for (auto &op : ops)
+        {
+            if (op->getOpType() != OpType::DequantizeLinear)
+                continue;
+            auto dequantize = as<DequantizeLinearObj>(op);
+            auto targets = dequantize->getOutput()->getTargets();
+            auto foldable = [&](const Operator &target)
+            {
+                return target->getOpType() == OpType::QuantizeLinear &&
+                       as<QuantizeLinearObj>(target)->getParams() ==
+                           dequantize->getParams() &&
+                       !target->getOutput()->getTargets().empty();
+            };
+            if (targets.empty() ||
+                !std::all_of(targets.begin(), targets.end(), foldable))
+                continue;
+            for (auto &quantize : targets)
+            {
+                auto qOut = quantize->getOutput();
+                for (auto &succ : qOut->getTargets())
+                    for (auto &input : succ->inputs)
+                        if (input == qOut)
+                            input = dequantize->getInputs(0);
+                removed.insert(quantize.get());
+                removeTensor(qOut);
+            }
+            removed.insert(dequantize.get());
+            removeTensor(dequantize->getOutput());
+            ++foldedPairs;
+        }
+        //    只服务于单个 DequantizeLinear 的 QuantizedMatMul 直接输出浮点结果
+        for (auto &op : ops)
+        {
+            if (op->getOpType() != OpType::DequantizeLinear || removed.count(op.get()))
+                continue;
+            auto yq = op->getInputs(0);
+            auto source = yq->getSource();
+            if (!source || source->getOpType() != OpType::QuantizedMatMul ||
+                yq->getTargets().size() != 1)
+                continue;
+            auto qmm = as<QuantizedMatmulObj>(source);
+            removed.insert(qmm.get());
+            removeTensor(yq);
+            op = make_ref<QuantizedMatmulObj>(
+                nullptr, qmm->getInputs(0), qmm->getInputs(1), op->getOutput(),
+                qmm->getAParams(), qmm->getBParams(), std::nullopt,
+                qmm->getTransB());
+        }
+        ops.erase(std::remove_if(ops.begin(), ops.end(),
+                                 [&](const Operator &op)
+                                 { return removed.count(op.get()); }),
+                  ops.end());
+        reconnect();
+
+        // 4. 重新分配内存，恢复权重并写入量化后的权重
+        dataMalloc();
+        for (auto &[tensor, data] : saved)
+            if (hasTensor(tensor))
+                std::memcpy(tensor->getRawDataPtr<void *>(), data.data(),
+                            data.size());
+        for (auto &[tensor, data] : weightData)
+            std::memcpy(tensor->getRawDataPtr<void *>(), data.data(), data.size());
+
+        // 5. 在同一批校准样本上运行量化后的图，统计输出的信噪比
+        vector<double> signal(outputs.size(), 0), noise(outputs.size(), 0);
+        for (size_t s = 0; s < calibration.size(); ++s)
+        {
+            feed(calibration[s]);
+            runtime->run(self);
+            for (size_t i = 0; i < outputs.size(); ++i)
+            {
+                auto data = outputs[i]->getRawDataPtr<float *>();
+                const float *ref = reference[i].data() + s * outputs[i]->size();
+                for (size_t j = 0; j < outputs[i]->size(); ++j)
+                {
+                    signal[i] += double(ref[j]) * ref[j];
+                    noise[i] += (double(ref[j]) - data[j]) * (double(ref[j]) - data[j]);
+                }
+            }
+        }
+        QuantizationReport report{quantizedOps, foldedPairs, {}};
+        for (size_t i = 0; i < outputs.size(); ++i)
+            report.sqnr.emplace_back(
+                noise[i] > 0 ? 10 * std::log10(signal[i] / noise[i])
+                             : std::numeric_limits<double>::infinity());
+        return report;
+    }
+
+} // namespace infini
@@ -0,0 +1,77 @@
+#include "core/request_pipeline.h"
+#include "core/runtime.h"
+#include <cstring>
+
+namespace infini
+{
+    RequestPipelineObj::RequestPipelineObj(const CompiledModel &model,
+                                           const TensorVec &outputs,
+                                           size_t depth)
+        : model(model),
+          outputs(outputs.empty() ? model->getGraph()->getOutputs() : outputs)
+    {
+        IT_ASSERT(depth > 0);
+        for (size_t s = 0; s < depth; ++s)
+        {
+            slots.emplace_back(make_ref<ExecutionContextObj>(model));
+            freeSlots.emplace_back(depth - 1 - s);
+        }
+    }
+
+    RequestPipelineObj::~RequestPipelineObj()
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        slotReleased.wait(lock, [&]
+                          { return freeSlots.size() == slots.size(); });
+    }
+
+    std::future<void>
+    RequestPipelineObj::submit(const vector<const void *> &inputData,
+                               const vector<void *> &outputData)
+    {
+        const auto &inputs = model->getInputs();
+        IT_ASSERT(inputData.size() == inputs.size() &&
+                      outputData.size() == outputs.size(),
+                  "RequestPipeline: wrong number of input or output buffers.");
+        size_t s;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            slotReleased.wait(lock, [&]
+                              { return !freeSlots.empty(); });
+            s = freeSlots.back();
+            freeSlots.pop_back();
+        }
+        // 在调用线程上暂存输入，与正在计算的上一个请求重叠
+        for (size_t i = 0; i < inputs.size(); ++i)
+            std::memcpy(slots[s]->getData(inputs[i]), inputData[i],
+                        inputs[i]->getBytes());
+
+        return model->getGraph()->getRuntime()->post(
+            [this, s, outputData]
+            {
+                // 无论成功与否都要归还槽位；通知在锁内完成，归还后不再访问
+                // this
+                auto release = [&]
+                {
+                    std::lock_guard<std::mutex> lock(mutex);
+                    freeSlots.emplace_back(s);
+                    slotReleased.notify_all();
+                };
+                const auto &slot = slots[s];
+                try
+                {
+                    slot->run();
+                    for (size_t i = 0; i < outputs.size(); ++i)
+                        std::memcpy(outputData[i], slot->getData(outputs[i]),
+                                    outputs[i]->getBytes());
+                }
+                catch (...)
+                {
+                    release();
+                    throw;
+                }
+                release();
+            });
+    }
+
+} // namespace infini
@@ -1,23 +1,102 @@
 #include "core/runtime.h"
 #include "core/blob.h"
+#include "core/execution_plan.h"
 #include "core/kernel.h"
 #include "core/graph.h"
-#include "core/kernel.h"
+#include "core/tuning_cache.h"
 #include <chrono>
 #include <cstring>
+#include <limits>
 #include <memory>
 namespace infini
 {
     void NativeCpuRuntimeObj::run(const Graph &graph) const
     {
+        run(graph->getExecutionPlan());
+    }
+
+    void RuntimeObj::run(const ExecutionPlanObj &plan) const
+    {
+        if (interOpThreads > 1)
+            plan.run(*threadPool, interOpThreads);
+        else
+            plan.run();
+    }
+
+    std::future<void> RuntimeObj::runAsync(const Graph &graph) const
+    {
+        return post([this, graph]
+                    { run(graph); });
+    }
+
+    std::future<void> RuntimeObj::post(std::function<void()> task) const
+    {
+        std::call_once(requestThreadStarted, [this]
+                       { requestThread = std::make_unique<SerialExecutor>(); });
+        return requestThread->post(std::move(task));
+    }
+
+    void RuntimeObj::setNumThreads(size_t threads, const vector<int> &cores)
+    {
+        if (threads == 0)
+            threads = std::max(1u, std::thread::hardware_concurrency());
+        // 调用 run 的线程也参与执行，因此只需 threads - 1 个工作线程
+        threadPool.reset();
+        threadPool = std::make_unique<ThreadPool>(threads - 1, cores);
+    }
+
+    void RuntimeObj::tune(const Graph &graph, const string &cachePath) const
+    {
+        // timed runs per candidate, after one warm-up run; the best is kept
+        constexpr int repeats = 5;
         const auto &kernelRegistry = KernelRegistry::getInstance();
+        auto &cache = TuningCache::getInstance();
+        if (!cachePath.empty())
+            cache.load(cachePath);
 
         for (auto &op : graph->getOperators())
         {
-            auto kernelAttrs = KernelAttrs{device, op->getOpType().underlying()};
-            Kernel *kernel = kernelRegistry.getKernel(kernelAttrs);
-            kernel->compute(op, this);
+            auto kernelAttrs = KernelAttrs{
+                device, op->getOpType().underlying(), op->getDType()};
+            const auto &candidates = kernelRegistry.getCandidates(kernelAttrs);
+            op->setKernel(nullptr);
+            if (candidates.size() < 2)
+                continue;
+            const string key = TuningCache::getKey(op, getNumThreads());
+            if (auto name = cache.get(key))
+            {
+                for (auto &[kernel, kernelName, id] : candidates)
+                    if (kernelName == *name)
+                        op->setKernel(kernel);
+                if (op->getKernel())
+                    continue;
+            }
+
+            double bestTime = std::numeric_limits<double>::infinity();
+            for (auto &[kernel, kernelName, id] : candidates)
+            {
+                kernel->compute(op, this);
+                double time = std::numeric_limits<double>::infinity();
+                for (int i = 0; i < repeats; ++i)
+                {
+                    auto begin = std::chrono::steady_clock::now();
+                    kernel->compute(op, this);
+                    std::chrono::duration<double> elapsed =
+                        std::chrono::steady_clock::now() - begin;
+                    time = std::min(time, elapsed.count());
+                }
+                if (time < bestTime)
+                {
+                    bestTime = time;
+                    op->setKernel(kernel);
+                    cache.set(key, kernelName);
+                }
+            }
         }
+
+        graph->invalidateExecutionPlan();
+        if (!cachePath.empty())
+            cache.save(cachePath);
     }
 
     string NativeCpuRuntimeObj::toString() const { return "CPU Runtime"; }
@@ -3,10 +3,64 @@
 #include "core/operator.h"
 #include "core/runtime.h"
 #include <cstring>
+#include <mutex>
 #include <numeric>
 
 namespace infini {
 
+    namespace
+    {
+        // symbol -k is names[k - 1]
+        struct SymbolTable
+        {
+            std::mutex mutex;
+            unordered_map<string, ShapeElem> symbols;
+            vector<string> names;
+        };
+
+        SymbolTable &getSymbolTable()
+        {
+            static SymbolTable table;
+            return table;
+        }
+    } // namespace
+
+    ShapeElem symbolicDim(const string &name)
+    {
+        auto &table = getSymbolTable();
+        std::lock_guard<std::mutex> lock(table.mutex);
+        auto it = table.symbols.find(name);
+        if (it == table.symbols.end())
+        {
+            table.names.emplace_back(name);
+            it = table.symbols.emplace(name, -ShapeElem(table.names.size()))
+                     .first;
+        }
+        return it->second;
+    }
+
+    string getSymbolName(ShapeElem symbol)
+    {
+        auto &table = getSymbolTable();
+        std::lock_guard<std::mutex> lock(table.mutex);
+        IT_ASSERT(isSymbolic(symbol) && size_t(-symbol) <= table.names.size(),
+                  "Unknown symbolic dimension.");
+        return table.names[-symbol - 1];
+    }
+
+    bool isSymbolic(const Shape &shape)
+    {
+        return std::any_of(shape.begin(), shape.end(),
+                           [](ShapeElem dim)
+                           { return isSymbolic(dim); });
+    }
+
+    Shape substitute(Shape shape, ShapeElem symbol, ShapeElem value)
+    {
+        std::replace(shape.begin(), shape.end(), symbol, value);
+        return shape;
+    }
+
     TensorObj::TensorObj(Shape shape_, DataType dtype, Runtime runtime)
         : dim(shape_.size()), dtype(dtype), runtime(runtime), shape(std::move(shape_)),
           _size(std::accumulate(shape.begin(), shape.end(), 1, std::multiplies{})) {}
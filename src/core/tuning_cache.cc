@@ -0,0 +1,57 @@
+#include "core/tuning_cache.h"
+#include "core/operator.h"
+#include "utils/cpu_features.h"
+#include <fstream>
+
+namespace infini
+{
+    string TuningCache::getKey(const Operator &op, size_t threads)
+    {
+        std::ostringstream os;
+        os << op->getOpType().toString() << ";" << op->getDType().toString()
+           << ";";
+        for (auto &input : op->getInputs())
+            os << vecToString(input->getDims());
+        os << ";" << vecToString(op->getOpAttrVector()) << ";" << threads
+           << ";" << getCpuModel()
+           << ";" << cpuIsaToString(getCpuIsa());
+        return os.str();
+    }
+
+    optional<string> TuningCache::get(const string &key) const
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        auto it = choices.find(key);
+        if (it == choices.end())
+            return std::nullopt;
+        return it->second;
+    }
+
+    void TuningCache::set(const string &key, const string &kernelName)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        choices[key] = kernelName;
+    }
+
+    void TuningCache::load(const string &path)
+    {
+        std::ifstream file(path);
+        string line;
+        std::lock_guard<std::mutex> lock(mutex);
+        while (std::getline(file, line))
+        {
+            auto tab = line.rfind('\t');
+            if (tab != string::npos)
+                choices[line.substr(0, tab)] = line.substr(tab + 1);
+        }
+    }
+
+    void TuningCache::save(const string &path) const
+    {
+        std::ofstream file(path);
+        IT_ASSERT(file.good(), "Cannot write tuning cache " + path);
+        std::lock_guard<std::mutex> lock(mutex);
+        for (auto &[key, kernelName] : choices)
+            file << key << '\t' << kernelName << '\n';
+    }
+} // namespace infini
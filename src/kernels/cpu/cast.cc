@@ -0,0 +1,142 @@
+#include "operators/unary.h"
+#include "core/kernel.h"
+#include "utils/half.h"
+#include "utils/vectorized.h"
+
+namespace infini {
+
+// Minimum number of elements converted by one thread.
+constexpr size_t CAST_GRAIN = 1 << 14;
+
+// Scalar conversion used when the host has no vector kernels. Template
+// arguments are DataType indices, since Float16 and BFloat16 share uint16_t
+// with UInt16.
+template <int From, int To>
+typename DT<To>::t castScalar(typename DT<From>::t x) {
+    if constexpr (From == 10)
+        return typename DT<To>::t(fp16ToFloat(x));
+    else if constexpr (From == 16)
+        return typename DT<To>::t(bf16ToFloat(x));
+    else if constexpr (To == 10)
+        return floatToFp16(float(x));
+    else if constexpr (To == 16)
+        return floatToBf16(float(x));
+    else
+        return typename DT<To>::t(x);
+}
+
+template <int From, int To>
+void castAll(const void *in, void *out, size_t n, ThreadPool &pool) {
+    auto inPtr = static_cast<const typename DT<From>::t *>(in);
+    auto outPtr = static_cast<typename DT<To>::t *>(out);
+    const auto run = getVectorKernels().cast[From][To];
+
+    pool.parallelFor(n, CAST_GRAIN, [&](size_t begin, size_t end) {
+        if (run) {
+            run(inPtr + begin, outPtr + begin, end - begin);
+            return;
+        }
+        for (size_t i = begin; i < end; ++i)
+            outPtr[i] = castScalar<From, To>(inPtr[i]);
+    });
+}
+
+using CastFn = void (*)(const void *in, void *out, size_t n,
+                       ThreadPool &pool);
+
+struct CastState : KernelState {
+    CastFn cast;
+    const void *in;
+    void *out;
+    size_t n;
+};
+
+class NativeCast : public CpuKernelWithoutConfig {
+    template <int From, int To>
+    static CastFn select(const Ref<CastObj> &op) {
+        IT_ASSERT(op->getInputs(0)->getDType() == DataType(From));
+        IT_ASSERT(op->getOutput()->getDType() == DataType(To));
+        return castAll<From, To>;
+    }
+
+    std::unique_ptr<KernelState>
+    prepare(const Operator &_op, const DataBinding &data) const override {
+        auto op = as<CastObj>(_op);
+        auto state = std::make_unique<CastState>();
+        state->in = data(op->getInputs(0));
+        state->out = data(op->getOutput());
+        state->n = op->getOutput()->size();
+        // DataType indices: Float32 1, UInt8 2, Int8 3, Int16 5, Int32 6,
+        // Int64 7, Float16 10, UInt32 12, BFloat16 16
+#define CASE(TYPE, FROM, TO)                                                   \
+    case CastType::TYPE:                                                       \
+        state->cast = select<FROM, TO>(op)
+
+        switch (op->getType()) {
+            CASE(Float2Float16, 1, 10);
+            break;
+            CASE(Float2Int64, 1, 7);
+            break;
+            CASE(Float2Int32, 1, 6);
+            break;
+            CASE(Float2Int16, 1, 5);
+            break;
+            CASE(Float2Int8, 1, 3);
+            break;
+            CASE(Float2BFloat16, 1, 16);
+            break;
+            CASE(Int322Float, 6, 1);
+            break;
+            CASE(Int322Int8, 6, 3);
+            break;
+            CASE(Int322Int16, 6, 5);
+            break;
+            CASE(Int322Int64, 6, 7);
+            break;
+            CASE(Int162Float, 5, 1);
+            break;
+            CASE(Int162Int32, 5, 6);
+            break;
+            CASE(Int82Float, 3, 1);
+            break;
+            CASE(Int82Int16, 3, 5);
+            break;
+            CASE(Int82Int32, 3, 6);
+            break;
+            CASE(Uint82Float, 2, 1);
+            break;
+            CASE(Uint82Int32, 2, 6);
+            break;
+            CASE(Uint82Int64, 2, 7);
+            break;
+            CASE(Int642Int32, 7, 6);
+            break;
+            CASE(Int642Uint32, 7, 12);
+            break;
+            CASE(Int642Float, 7, 1);
+            break;
+            CASE(Uint322Int64, 12, 7);
+            break;
+            CASE(Float162Float, 10, 1);
+            break;
+            CASE(BFloat162Float, 16, 1);
+            break;
+            CASE(Float2Float, 1, 1);
+            break;
+        default:
+            IT_TODO_HALT();
+        }
+#undef CASE
+        return state;
+    }
+
+    void run(const KernelState &_state,
+             const RuntimeObj *context) const override {
+        const auto &state = static_cast<const CastState &>(_state);
+        state.cast(state.in, state.out, state.n, context->getThreadPool());
+    }
+};
+
+REGISTER_KERNEL(Device::CPU, OpType::Cast, NativeCast, "Cast_CPU");
+
+} // namespace infini
@@ -1,61 +1,102 @@
 #include "operators/concat.h"
 #include "core/kernel.h"
+#include <algorithm>
+#include <cstring>
 
 namespace infini {
 
+// Bytes copied by one task, and the least a thread is given. Runs longer
+// than this are split so that a single large input does not serialize the
+// whole concat.
+constexpr size_t CONCAT_GRAIN = 1 << 16;
+
+// Concat only moves data, so everything is in bytes. Each outer block of
+// input i is one contiguous run of localBlockOffset[i] bytes, which lands at
+// innerOffset[i] inside the matching output block. Runs are cut into chunks,
+// and tasks are the (outer block, chunk) pairs; input i owns chunks
+// [firstChunk[i], firstChunk[i + 1]), and the chunks of one outer block
+// copy bytesPerBlock bytes in all.
+struct ConcatState : KernelState {
+    uint8_t *out;
+    vector<const uint8_t *> in;
+    vector<size_t> localBlockOffset, innerOffset, firstChunk;
+    size_t outer, blockOffset, bytesPerBlock = 0;
+};
+
 class NaiveConcat : public CpuKernelWithoutConfig {
-    template <typename T>
-    void doCompute(const Operator &_op, const RuntimeObj *context) const {
+    std::unique_ptr<KernelState>
+    prepare(const Operator &_op, const DataBinding &data) const override {
         auto op = as<ConcatObj>(_op);
-        auto inputs = op->getInputs(), outputs = op->getOutputs();
+        const auto &inputs = op->getInputs();
         auto dim = op->getDim();
-        auto output = outputs[0];
-        std::vector<Shape> iDims;
-        for (auto input : inputs)
-            iDims.emplace_back(input->getDims());
-        const auto &outDim = output->getDims();
-        size_t blockOffsetInner = 1;
+        const auto &outDim = op->getOutput()->getDims();
+        const size_t elemSize = op->getDType().getSize();
+        auto state = std::make_unique<ConcatState>();
+        state->outer = 1;
+        for (int i = 0; i < dim; ++i)
+            state->outer *= outDim[i];
+        size_t blockOffsetInner = elemSize;
         for (size_t i = outDim.size() - 1; i > (size_t)dim; --i)
             blockOffsetInner *= outDim[i];
-        size_t blockOffset = outDim[dim] * blockOffsetInner;
-        for (size_t i = 0; i < inputs.size(); ++i) {
-            auto input = inputs[i];
-            auto dimOffset = 0;
-            auto iDim = iDims[i];
-            for (size_t j = 0; j < i; ++j)
-                dimOffset += iDims[j][dim];
-            size_t localBlockOffset = 1;
-            for (size_t i = iDim.size() - 1;
-                 i >= (size_t)dim && i != (size_t)-1; --i)
-                localBlockOffset *= iDim[i];
-            auto innerOffset = blockOffsetInner * dimOffset;
-            auto inSize = input->size();
-            auto inPtr = input->getRawDataPtr<T *>(),
-                 outPtr = output->getRawDataPtr<T *>();
-#pragma omp parallel for
-            for (size_t iOffset = 0; iOffset < inSize; ++iOffset) {
-                auto oOffset = iOffset % localBlockOffset + innerOffset +
-                               iOffset / localBlockOffset * blockOffset;
-                outPtr[oOffset] = inPtr[iOffset];
-            }
+        state->blockOffset = outDim[dim] * blockOffsetInner;
+
+        // With a single outer block, GraphObj::dataMalloc may already have
+        // placed an input inside the output; such inputs get no chunks.
+        const size_t n = inputs.size();
+        state->out = static_cast<uint8_t *>(data(op->getOutput()));
+        state->in.resize(n);
+        state->localBlockOffset.resize(n);
+        state->innerOffset.resize(n);
+        state->firstChunk.resize(n + 1);
+        for (size_t i = 0, dimOffset = 0; i < n; ++i) {
+            auto iDimAxis = inputs[i]->getDims()[dim];
+            state->in[i] = static_cast<const uint8_t *>(data(inputs[i]));
+            state->localBlockOffset[i] = iDimAxis * blockOffsetInner;
+            state->innerOffset[i] = dimOffset * blockOffsetInner;
+            dimOffset += iDimAxis;
+            bool inPlace = state->outer == 1 &&
+                           state->in[i] == state->out + state->innerOffset[i];
+            state->firstChunk[i + 1] =
+                state->firstChunk[i] +
+                (inPlace ? 0
+                         : (state->localBlockOffset[i] + CONCAT_GRAIN - 1) /
+                               CONCAT_GRAIN);
+            if (!inPlace)
+                state->bytesPerBlock += state->localBlockOffset[i];
         }
+        return state;
     }
 
-    void compute(const Operator &_op,
-                 const RuntimeObj *context) const override {
-#define CASE(N)                                                                \
-    case N:                                                                    \
-        doCompute<DT<N>::t>(_op, context)
+    void run(const KernelState &_state,
+             const RuntimeObj *context) const override {
+        const auto &state = static_cast<const ConcatState &>(_state);
+        const auto &firstChunk = state.firstChunk;
+        const size_t chunksPerBlock = firstChunk.back();
+        const size_t nTasks = state.outer * chunksPerBlock;
+        if (nTasks == 0)
+            return;
+        // tasks of small runs are grouped up to CONCAT_GRAIN bytes per thread
+        const size_t grain =
+            CONCAT_GRAIN * chunksPerBlock / std::max<size_t>(1, state.bytesPerBlock);
 
-        int dataTypeIdx = _op->getDType().getIndex();
-        switch (dataTypeIdx) {
-            CASE(1); // DataType::Float32
-            break;
-            CASE(12); // DataType::UInt32
-            break;
-        default:
-            IT_TODO_HALT();
-        }
+        context->getThreadPool().parallelFor(
+            nTasks, grain, [&](size_t taskBegin, size_t taskEnd) {
+                for (size_t task = taskBegin; task < taskEnd; ++task) {
+                    const size_t block = task / chunksPerBlock;
+                    const size_t chunk = task % chunksPerBlock;
+                    const size_t i = std::upper_bound(firstChunk.begin(),
+                                                      firstChunk.end(), chunk) -
+                                     firstChunk.begin() - 1;
+                    const size_t begin = (chunk - firstChunk[i]) * CONCAT_GRAIN;
+                    const size_t bytes =
+                        std::min(CONCAT_GRAIN, state.localBlockOffset[i] - begin);
+                    std::memcpy(state.out + block * state.blockOffset +
+                                    state.innerOffset[i] + begin,
+                                state.in[i] + block * state.localBlockOffset[i] +
+                                    begin,
+                                bytes);
+                }
+            });
     }
 };
 
@@ -1,9 +1,27 @@
 #include "operators/element_wise.h"
 #include "core/kernel.h"
+#include "utils/half.h"
 #include "utils/operator_utils.h"
+#include "utils/vectorized.h"
 
 namespace infini
 {
+    // Broadcast layout of an element-wise op with adjacent dimensions of the
+    // same broadcast pattern merged, its data pointers, and the routine
+    // prepare() picked for the op type and data type. The innermost merged
+    // dimension is processed as contiguous runs, cut into chunks of rows or
+    // of row segments.
+    struct ElementWiseState : KernelState
+    {
+        using Fn = void (*)(const ElementWiseState &state, ThreadPool &pool);
+        Fn run;
+        const void *a, *b;
+        void *c;
+        DataType dtype;
+        vector<size_t> dims, strideA, strideB;
+        size_t rows, rowsPerChunk, segments, nChunks;
+    };
+
     class NativeElementWise : public CpuKernelWithoutConfig
     {
         template <typename T>
@@ -30,13 +48,188 @@ namespace infini
             return (T)(val0 / val1);
         }
 
+        // Elements in one chunk; tensors of one chunk stay on a single thread.
+        static constexpr size_t grain = 1 << 15;
+
+        // Apply `_doCompute` along one contiguous run of n output elements. A zero
+        // stride means the input is broadcast along the run.
+        template <typename T, T (*_doCompute)(T, T)>
+        static void computeRun(const T *a, size_t sa, const T *b, size_t sb,
+                               T *c, size_t n)
+        {
+            if (sa && sb)
+                for (size_t i = 0; i < n; ++i)
+                    c[i] = _doCompute(a[i], b[i]);
+            else if (sa)
+            {
+                const T y = *b;
+                for (size_t i = 0; i < n; ++i)
+                    c[i] = _doCompute(a[i], y);
+            }
+            else if (sb)
+            {
+                const T x = *a;
+                for (size_t i = 0; i < n; ++i)
+                    c[i] = _doCompute(x, b[i]);
+            }
+            else
+                std::fill_n(c, n, _doCompute(*a, *b));
+        }
+
+        // Float16/BFloat16 runs are widened to float in blocks of this many
+        // elements, computed in float and rounded back.
+        static constexpr size_t halfBlock = 256;
+
+        // Walk the broadcast layout and hand every contiguous run of output
+        // elements to `run(a, sa, b, sb, c, n)`, chunks spread over `pool`.
+        template <typename T, typename Run>
+        static void forEachRun(const ElementWiseState &state, ThreadPool &pool,
+                               const Run &run)
+        {
+            const T *inptr0 = static_cast<const T *>(state.a);
+            const T *inptr1 = static_cast<const T *>(state.b);
+            T *outptr = static_cast<T *>(state.c);
+            const auto &dims = state.dims;
+            const auto &strideA = state.strideA, &strideB = state.strideB;
+            const size_t inner = dims.back();
+            const size_t sa = strideA.back(), sb = strideB.back();
+            const size_t outer = dims.size() - 1;
+            const size_t rows = state.rows, rowsPerChunk = state.rowsPerChunk,
+                         segments = state.segments;
+
+            auto runChunks = [&](size_t chunkBegin, size_t chunkEnd)
+            {
+                for (size_t chunk = chunkBegin; chunk < chunkEnd; ++chunk)
+                {
+                    size_t rowBegin, rowEnd, colBegin = 0, colEnd = inner;
+                    if (rowsPerChunk > 1)
+                    {
+                        rowBegin = chunk * rowsPerChunk;
+                        rowEnd = std::min(rows, rowBegin + rowsPerChunk);
+                    }
+                    else
+                    {
+                        rowBegin = chunk / segments, rowEnd = rowBegin + 1;
+                        colBegin = chunk % segments * grain;
+                        colEnd = std::min(inner, colBegin + grain);
+                    }
+                    // locate the first row once, then step incrementally
+                    vector<size_t> index(outer);
+                    size_t offsetA = 0, offsetB = 0;
+                    for (size_t i = outer, rest = rowBegin; i-- > 0;)
+                    {
+                        index[i] = rest % dims[i];
+                        rest /= dims[i];
+                        offsetA += index[i] * strideA[i];
+                        offsetB += index[i] * strideB[i];
+                    }
+                    for (size_t row = rowBegin; row < rowEnd; ++row)
+                    {
+                        const T *runA = inptr0 + offsetA + colBegin * sa;
+                        const T *runB = inptr1 + offsetB + colBegin * sb;
+                        T *runC = outptr + row * inner + colBegin;
+                        run(runA, sa, runB, sb, runC, colEnd - colBegin);
+                        for (size_t i = outer; i-- > 0;)
+                        {
+                            offsetA += strideA[i];
+                            offsetB += strideB[i];
+                            if (++index[i] < dims[i])
+                                break;
+                            offsetA -= strideA[i] * dims[i];
+                            offsetB -= strideB[i] * dims[i];
+                            index[i] = 0;
+                        }
+                    }
+                }
+            };
+            pool.parallelFor(state.nChunks, 1, runChunks);
+        }
+
+        template <typename T, T (*_doCompute)(T, T), VecBinary vecOp>
+        static void doCompute(const ElementWiseState &state, ThreadPool &pool)
+        {
+            // SIMD kernel for the host's instruction set, if there is one
+            const auto vecRun = getVectorKernels().binary<T>(vecOp);
+            auto run = [&](const T *a, size_t sa, const T *b, size_t sb,
+                           T *c, size_t n)
+            {
+                if (vecRun)
+                    vecRun(a, sa, b, sb, c, n);
+                else
+                    computeRun<T, _doCompute>(a, sa, b, sb, c, n);
+            };
+            forEachRun<T>(state, pool, run);
+        }
+
+        template <float (*_doCompute)(float, float), VecBinary vecOp>
+        static void doComputeHalf(const ElementWiseState &state,
+                                  ThreadPool &pool)
+        {
+            const auto vecRun = getVectorKernels().binary<float>(vecOp);
+            const DataType dtype = state.dtype;
+            auto run = [&](const uint16_t *a, size_t sa, const uint16_t *b,
+                           size_t sb, uint16_t *c, size_t n)
+            {
+                float fa[halfBlock], fb[halfBlock], fc[halfBlock];
+                for (size_t i = 0; i < n; i += halfBlock)
+                {
+                    const size_t len = std::min(halfBlock, n - i);
+                    halfToFloat(dtype, a + i * sa, fa, sa ? len : 1);
+                    halfToFloat(dtype, b + i * sb, fb, sb ? len : 1);
+                    if (vecRun)
+                        vecRun(fa, sa, fb, sb, fc, len);
+                    else
+                        computeRun<float, _doCompute>(fa, sa, fb, sb, fc, len);
+                    floatToHalf(dtype, fc, c + i, len);
+                }
+            };
+            forEachRun<uint16_t>(state, pool, run);
+        }
+
         template <typename T>
-        void doCompute(const Operator &_op, const RuntimeObj *context) const
+        static ElementWiseState::Fn select(OpType type)
+        {
+            switch (type.underlying())
+            {
+            case OpType::Add:
+                return doCompute<T, addCompute<T>, VecBinary::Add>;
+            case OpType::Sub:
+                return doCompute<T, subCompute<T>, VecBinary::Sub>;
+            case OpType::Mul:
+                return doCompute<T, mulCompute<T>, VecBinary::Mul>;
+            case OpType::Div:
+                return doCompute<T, divCompute<T>, VecBinary::Div>;
+            default:
+                IT_TODO_HALT();
+            }
+        }
+
+        static ElementWiseState::Fn selectHalf(OpType type)
+        {
+            switch (type.underlying())
+            {
+            case OpType::Add:
+                return doComputeHalf<addCompute<float>, VecBinary::Add>;
+            case OpType::Sub:
+                return doComputeHalf<subCompute<float>, VecBinary::Sub>;
+            case OpType::Mul:
+                return doComputeHalf<mulCompute<float>, VecBinary::Mul>;
+            case OpType::Div:
+                return doComputeHalf<divCompute<float>, VecBinary::Div>;
+            default:
+                IT_TODO_HALT();
+            }
+        }
+
+        std::unique_ptr<KernelState>
+        prepare(const Operator &_op, const DataBinding &data) const override
         {
             auto op = as<ElementWiseObj>(_op);
-            T *inptr0 = op->getInputs(0)->getRawDataPtr<T *>();
-            T *inptr1 = op->getInputs(1)->getRawDataPtr<T *>();
-            T *outptr = op->getOutput()->getRawDataPtr<T *>();
+            auto state = std::make_unique<ElementWiseState>();
+            state->a = data(op->getInputs(0));
+            state->b = data(op->getInputs(1));
+            state->c = data(op->getOutput());
+            state->dtype = op->getDType();
 
             auto shapeA = op->getInputs(0)->getDims();
             auto shapeB = op->getInputs(1)->getDims();
@@ -48,67 +241,74 @@ namespace infini
                       a.begin() + (rank - shapeA.size()));
             std::copy(shapeB.begin(), shapeB.end(),
                       b.begin() + (rank - shapeB.size()));
-            auto getStride = [&](const Shape &shape)
+
+            // Merge adjacent dimensions with the same broadcast pattern, so
+            // that identical shapes, scalar, row, column and trailing
+            // broadcasts all become one or two dimensions.
+            auto &dims = state->dims;
+            vector<bool> fullA, fullB;
+            for (size_t i = 0; i < rank; ++i)
             {
-                int p = 1;
-                Shape stride(rank);
-                for (auto i = rank; i > 0; --i)
+                if (shapeC[i] == 1)
+                    continue;
+                bool fa = a[i] != 1, fb = b[i] != 1;
+                if (!dims.empty() && fullA.back() == fa && fullB.back() == fb)
+                    dims.back() *= shapeC[i];
+                else
                 {
-                    stride[i - 1] = p;
-                    p = p * shape[i - 1];
+                    dims.emplace_back(shapeC[i]);
+                    fullA.emplace_back(fa);
+                    fullB.emplace_back(fb);
                 }
-                return stride;
-            };
-            Shape strideA = getStride(a);
-            Shape strideB = getStride(b);
-
-            auto n = op->getOutput()->size();
-            T (*_doCompute)
-            (T val0, T val1);
-            switch (op->getOpType().underlying())
+            }
+            if (dims.empty())
             {
-            case OpType::Add:
-                _doCompute = addCompute<T>;
-                break;
-            case OpType::Sub:
-                _doCompute = subCompute<T>;
-                break;
-            case OpType::Mul:
-                _doCompute = mulCompute<T>;
-                break;
-            case OpType::Div:
-                _doCompute = divCompute<T>;
-                break;
-            default:
-                IT_TODO_HALT();
+                dims = {1};
+                fullA = fullB = {true};
             }
-
-            for (size_t i = 0; i < n; ++i)
+            size_t nDims = dims.size();
+            state->strideA.resize(nDims);
+            state->strideB.resize(nDims);
+            for (size_t i = nDims, pa = 1, pb = 1; i-- > 0;)
             {
-                auto shapeIndexC = locate_index(i, shapeC);
-                auto indexA = delocate_index(shapeIndexC, a, strideA);
-                auto indexB = delocate_index(shapeIndexC, b, strideB);
-                outptr[i] = _doCompute(inptr0[indexA], inptr1[indexB]);
+                state->strideA[i] = fullA[i] ? pa : 0;
+                state->strideB[i] = fullB[i] ? pb : 0;
+                pa *= fullA[i] ? dims[i] : 1;
+                pb *= fullB[i] ? dims[i] : 1;
             }
-        }
 
-        void compute(const Operator &_op,
-                     const RuntimeObj *context) const override
-        {
-#define CASE(N) \
-    case N:     \
-        doCompute<DT<N>::t>(_op, context)
+            const size_t inner = dims.back();
+            state->rows = op->getOutput()->size() / inner;
+            state->rowsPerChunk = std::max<size_t>(1, grain / inner);
+            state->segments = (inner + grain - 1) / grain;
+            state->nChunks =
+                state->rowsPerChunk > 1
+                    ? (state->rows + state->rowsPerChunk - 1) / state->rowsPerChunk
+                    : state->rows * state->segments;
 
-            int dataTypeIdx = _op->getDType().getIndex();
-            switch (dataTypeIdx)
+            switch (state->dtype.getIndex())
             {
-                CASE(1); // DataType::Float32
+            case 1: // DataType::Float32
+                state->run = select<float>(op->getOpType());
                 break;
-                CASE(12); // DataType::UInt32
+            case 12: // DataType::UInt32
+                state->run = select<uint32_t>(op->getOpType());
+                break;
+            case 10: // DataType::Float16
+            case 16: // DataType::BFloat16
+                state->run = selectHalf(op->getOpType());
                 break;
             default:
                 IT_TODO_HALT();
             }
+            return state;
+        }
+
+        void run(const KernelState &state,
+                 const RuntimeObj *context) const override
+        {
+            auto &elementWise = static_cast<const ElementWiseState &>(state);
+            elementWise.run(elementWise, context->getThreadPool());
         }
     };
 
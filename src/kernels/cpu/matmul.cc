@@ -0,0 +1,380 @@
+#include "operators/matmul.h"
+#include "core/kernel.h"
+#include "utils/cpu_features.h"
+#include "utils/half.h"
+#include <immintrin.h>
+
+namespace infini {
+
+namespace {
+
+// Register block of the microkernel. 6x16 floats keep 12 ymm accumulators
+// live plus 2 registers for the B row and 1 for the broadcast A element.
+constexpr int MR = 6;
+constexpr int NR = 16;
+// Cache blocks. An MR x kc sliver of A and a kc x NR sliver of B fit in L1,
+// an mc x kc block of A in L2, and a kc x nc panel of B in L3. The best sizes
+// depend on the host's caches, so several are registered for the autotuner.
+struct GemmBlocking {
+    int mc, kc, nc;
+};
+// Minimum number of multiply-adds (or packed elements) given to a thread.
+constexpr size_t GEMM_GRAIN = 1 << 15;
+
+// Grain, in loop iterations, of a loop doing `work` multiply-adds each.
+size_t grainOf(size_t work) { return GEMM_GRAIN / std::max<size_t>(1, work); }
+
+// A row-major matrix view with arbitrary row/column strides, used to express
+// transA/transB without materializing the transposed operand.
+template <typename T> struct MatView {
+    const T *ptr;
+    size_t rs, cs;
+    T at(size_t i, size_t j) const { return ptr[i * rs + j * cs]; }
+};
+
+// Pack rows [i0, i0 + mc) and columns [p0, p0 + kc) of A into MR-row panels
+// stored column by column. Rows past the matrix end are zero-padded.
+template <typename T>
+void packA(const MatView<T> &a, int i0, int mc, int p0, int kc, T *buf) {
+    for (int ir = 0; ir < mc; ir += MR) {
+        int mr = std::min(MR, mc - ir);
+        T *panel = buf + (size_t)ir * kc;
+        for (int p = 0; p < kc; ++p) {
+            for (int i = 0; i < mr; ++i)
+                panel[p * MR + i] = a.at(i0 + ir + i, p0 + p);
+            for (int i = mr; i < MR; ++i)
+                panel[p * MR + i] = T(0);
+        }
+    }
+}
+
+// Pack rows [p0, p0 + kc) and columns [j0, j0 + nc) of B into NR-column
+// panels stored row by row. Columns past the matrix end are zero-padded.
+template <typename T>
+void packB(const MatView<T> &b, int p0, int kc, int j0, int nc, T *buf) {
+    for (int jr = 0; jr < nc; jr += NR) {
+        int nr = std::min(NR, nc - jr);
+        T *panel = buf + (size_t)jr * kc;
+        if (b.cs == 1 && nr == NR) {
+            for (int p = 0; p < kc; ++p)
+                std::copy_n(b.ptr + (p0 + p) * b.rs + j0 + jr, NR,
+                            panel + p * NR);
+            continue;
+        }
+        for (int p = 0; p < kc; ++p) {
+            for (int j = 0; j < nr; ++j)
+                panel[p * NR + j] = b.at(p0 + p, j0 + jr + j);
+            for (int j = nr; j < NR; ++j)
+                panel[p * NR + j] = T(0);
+        }
+    }
+}
+
+// C[0:MR, 0:NR] (+)= Apanel * Bpanel. The fixed trip counts let the compiler
+// vectorize the inner loop for any element type.
+template <typename T>
+void microKernelGeneric(int kc, const T *a, const T *b, T *c, size_t ldc,
+                        bool accumulate) {
+    T ab[MR][NR] = {};
+    for (int p = 0; p < kc; ++p, a += MR, b += NR)
+        for (int i = 0; i < MR; ++i)
+            for (int j = 0; j < NR; ++j)
+                ab[i][j] += a[i] * b[j];
+    for (int i = 0; i < MR; ++i)
+        for (int j = 0; j < NR; ++j)
+            c[i * ldc + j] = accumulate ? c[i * ldc + j] + ab[i][j] : ab[i][j];
+}
+
+__attribute__((target("avx2,fma"))) inline void
+storeRowAvx2(float *row, __m256 lo, __m256 hi, bool accumulate) {
+    if (accumulate) {
+        lo = _mm256_add_ps(lo, _mm256_loadu_ps(row));
+        hi = _mm256_add_ps(hi, _mm256_loadu_ps(row + 8));
+    }
+    _mm256_storeu_ps(row, lo);
+    _mm256_storeu_ps(row + 8, hi);
+}
+
+__attribute__((target("avx2,fma"))) void
+microKernelAvx2(int kc, const float *a, const float *b, float *c, size_t ldc,
+                bool accumulate) {
+    __m256 c00 = _mm256_setzero_ps(), c01 = _mm256_setzero_ps();
+    __m256 c10 = _mm256_setzero_ps(), c11 = _mm256_setzero_ps();
+    __m256 c20 = _mm256_setzero_ps(), c21 = _mm256_setzero_ps();
+    __m256 c30 = _mm256_setzero_ps(), c31 = _mm256_setzero_ps();
+    __m256 c40 = _mm256_setzero_ps(), c41 = _mm256_setzero_ps();
+    __m256 c50 = _mm256_setzero_ps(), c51 = _mm256_setzero_ps();
+    for (int p = 0; p < kc; ++p, a += MR, b += NR) {
+        __m256 b0 = _mm256_loadu_ps(b), b1 = _mm256_loadu_ps(b + 8);
+        __m256 ai = _mm256_broadcast_ss(a + 0);
+        c00 = _mm256_fmadd_ps(ai, b0, c00), c01 = _mm256_fmadd_ps(ai, b1, c01);
+        ai = _mm256_broadcast_ss(a + 1);
+        c10 = _mm256_fmadd_ps(ai, b0, c10), c11 = _mm256_fmadd_ps(ai, b1, c11);
+        ai = _mm256_broadcast_ss(a + 2);
+        c20 = _mm256_fmadd_ps(ai, b0, c20), c21 = _mm256_fmadd_ps(ai, b1, c21);
+        ai = _mm256_broadcast_ss(a + 3);
+        c30 = _mm256_fmadd_ps(ai, b0, c30), c31 = _mm256_fmadd_ps(ai, b1, c31);
+        ai = _mm256_broadcast_ss(a + 4);
+        c40 = _mm256_fmadd_ps(ai, b0, c40), c41 = _mm256_fmadd_ps(ai, b1, c41);
+        ai = _mm256_broadcast_ss(a + 5);
+        c50 = _mm256_fmadd_ps(ai, b0, c50), c51 = _mm256_fmadd_ps(ai, b1, c51);
+    }
+    storeRowAvx2(c + 0 * ldc, c00, c01, accumulate);
+    storeRowAvx2(c + 1 * ldc, c10, c11, accumulate);
+    storeRowAvx2(c + 2 * ldc, c20, c21, accumulate);
+    storeRowAvx2(c + 3 * ldc, c30, c31, accumulate);
+    storeRowAvx2(c + 4 * ldc, c40, c41, accumulate);
+    storeRowAvx2(c + 5 * ldc, c50, c51, accumulate);
+}
+
+template <typename T>
+using MicroKernel = void (*)(int, const T *, const T *, T *, size_t, bool);
+
+template <typename T> MicroKernel<T> selectMicroKernel() {
+    if constexpr (std::is_same_v<T, float>) {
+        static const MicroKernel<float> kernel =
+            getCpuIsa() >= CpuIsa::AVX2 ? microKernelAvx2
+                : microKernelGeneric<float>;
+        return kernel;
+    }
+    return microKernelGeneric<T>;
+}
+
+// C = A * B for a single m x n x k problem. C is dense row-major with
+// leading dimension n; A and B are arbitrary strided views.
+template <typename T>
+void gemm(const GemmBlocking &blocking, int m, int n, int k,
+          const MatView<T> &a, const MatView<T> &b, T *c, vector<T> &bufA,
+          vector<T> &bufB, ThreadPool &pool) {
+    const int MC = blocking.mc, KC = blocking.kc, NC = blocking.nc;
+    if (k == 0) {
+        std::fill_n(c, (size_t)m * n, T(0));
+        return;
+    }
+    const auto microKernel = selectMicroKernel<T>();
+    const int mPadded = (m + MR - 1) / MR * MR;
+    bufA.resize((size_t)mPadded * KC);
+    bufB.resize((size_t)(NC + NR) * KC);
+
+    for (int jc = 0; jc < n; jc += NC) {
+        const int nc = std::min(NC, n - jc);
+        const int nPanels = (nc + NR - 1) / NR;
+        for (int pc = 0; pc < k; pc += KC) {
+            const int kc = std::min(KC, k - pc);
+            const bool accumulate = pc > 0;
+            T *pa = bufA.data(), *pb = bufB.data();
+
+            pool.parallelFor(nPanels, grainOf((size_t)NR * kc),
+                             [&](size_t begin, size_t end) {
+                for (int jp = begin; jp < (int)end; ++jp)
+                    packB(b, pc, kc, jc + jp * NR, std::min(NR, nc - jp * NR),
+                          pb + (size_t)jp * NR * kc);
+            });
+            pool.parallelFor(mPadded / MR, grainOf((size_t)MR * kc),
+                             [&](size_t begin, size_t end) {
+                for (int ip = begin; ip < (int)end; ++ip)
+                    packA(a, ip * MR, std::min(MR, m - ip * MR), pc, kc,
+                          pa + (size_t)ip * MR * kc);
+            });
+
+            // Work is split into MC x NC/nGroups tiles so that small-m
+            // problems (e.g. batch 1 inference) still use every thread.
+            const int mBlocks = (m + MC - 1) / MC;
+            const int nGroups = std::min(nPanels, 8);
+            pool.parallelFor(
+                (size_t)mBlocks * nGroups,
+                grainOf((size_t)std::min(m, MC) * nc / nGroups * kc),
+                [&](size_t begin, size_t end) {
+                for (size_t item = begin; item < end; ++item) {
+                    const int ib = item / nGroups, g = item % nGroups;
+                    const int iEnd = std::min(m, (ib + 1) * MC);
+                    const int jpBegin = nPanels * g / nGroups;
+                    const int jpEnd = nPanels * (g + 1) / nGroups;
+                    T tmp[MR * NR];
+                    for (int jp = jpBegin; jp < jpEnd; ++jp) {
+                        const int j = jp * NR, nr = std::min(NR, nc - j);
+                        const T *panelB = pb + (size_t)j * kc;
+                        for (int i = ib * MC; i < iEnd; i += MR) {
+                            const int mr = std::min(MR, iEnd - i);
+                            const T *panelA = pa + (size_t)i * kc;
+                            T *cTile = c + (size_t)i * n + jc + j;
+                            if (mr == MR && nr == NR) {
+                                microKernel(kc, panelA, panelB, cTile, n,
+                                            accumulate);
+                                continue;
+                            }
+                            // Edge tile: compute a full block into scratch
+                            // and write back only the valid part.
+                            microKernel(kc, panelA, panelB, tmp, NR, false);
+                            for (int ii = 0; ii < mr; ++ii)
+                                for (int jj = 0; jj < nr; ++jj) {
+                                    T &dst = cTile[(size_t)ii * n + jj];
+                                    dst = accumulate ? dst + tmp[ii * NR + jj]
+                                                     : tmp[ii * NR + jj];
+                                }
+                        }
+                    }
+                }
+            });
+        }
+    }
+}
+
+} // namespace
+
+// Data pointers and problem size of a MatMul, with the offsets of A and B
+// for every batch of C after broadcasting the leading dimensions.
+struct MatmulState : KernelState {
+    const void *a, *b;
+    void *c;
+    DataType dtype;
+    int m, n, k;
+    bool transA, transB;
+    vector<size_t> aOffset, bOffset;
+    size_t aSize, bSize, cSize;
+};
+
+class BlockedMatmul : public CpuKernelWithoutConfig {
+    const GemmBlocking blocking;
+
+    // Batches are shared out among the threads too, so that batches of
+    // small matrices, each below the grain, still run in parallel.
+    template <typename T>
+    void multiply(const MatmulState &state, const T *aPtr, const T *bPtr,
+                  T *cPtr, ThreadPool &pool) const {
+        const int m = state.m, n = state.n, k = state.k;
+        pool.parallelFor(
+            state.aOffset.size(), grainOf((size_t)m * n * k),
+            [&](size_t begin, size_t end) {
+                vector<T> bufA, bufB;
+                for (size_t bi = begin; bi < end; ++bi) {
+                    // A is stored as m x k (or k x m if transA); B as k x n
+                    // (or n x k if transB).
+                    MatView<T> a{aPtr + state.aOffset[bi],
+                                 state.transA ? 1 : (size_t)k,
+                                 state.transA ? (size_t)m : 1};
+                    MatView<T> b{bPtr + state.bOffset[bi],
+                                 state.transB ? 1 : (size_t)n,
+                                 state.transB ? (size_t)k : 1};
+                    gemm(blocking, m, n, k, a, b, cPtr + bi * m * n, bufA,
+                         bufB, pool);
+                }
+            });
+    }
+
+    // Float16/BFloat16 operands are widened to float once, multiplied and
+    // accumulated in float, and the result is rounded back at the end.
+    void multiplyHalf(const MatmulState &state, ThreadPool &pool) const {
+        vector<float> a(state.aSize), b(state.bSize), c(state.cSize);
+        halfToFloat(state.dtype, static_cast<const uint16_t *>(state.a),
+                    a.data(), a.size());
+        halfToFloat(state.dtype, static_cast<const uint16_t *>(state.b),
+                    b.data(), b.size());
+        multiply(state, a.data(), b.data(), c.data(), pool);
+        floatToHalf(state.dtype, c.data(), static_cast<uint16_t *>(state.c),
+                    c.size());
+    }
+
+  public:
+    explicit BlockedMatmul(GemmBlocking blocking = {144, 256, 3072})
+        : blocking(blocking) {}
+
+    std::unique_ptr<KernelState>
+    prepare(const Operator &_op, const DataBinding &data) const override {
+        auto op = as<MatmulObj>(_op);
+        auto A = op->getInputs(0), B = op->getInputs(1), C = op->getOutput();
+        auto state = std::make_unique<MatmulState>();
+        state->a = data(A);
+        state->b = data(B);
+        state->c = data(C);
+        state->dtype = op->getDType();
+        const int m = state->m = op->getM(), n = state->n = op->getN(),
+                  k = state->k = op->getK();
+        state->transA = op->getTransA();
+        state->transB = op->getTransB();
+        state->aSize = A->size();
+        state->bSize = B->size();
+        state->cSize = C->size();
+        switch (state->dtype.getIndex()) {
+        case 1:  // DataType::Float32
+        case 12: // DataType::UInt32
+        case 10: // DataType::Float16
+        case 16: // DataType::BFloat16
+            break;
+        default:
+            IT_TODO_HALT();
+        }
+
+        // Leading batch dimensions of A and B are broadcast against C's.
+        const auto &aDims = A->getDims(), &bDims = B->getDims(),
+                   &cDims = C->getDims();
+        const int batchRank = (int)cDims.size() - 2;
+        size_t batch = 1;
+        for (int i = 0; i < batchRank; ++i)
+            batch *= cDims[i];
+        vector<size_t> aStride(batchRank), bStride(batchRank);
+        size_t aStep = (size_t)m * k, bStep = (size_t)k * n;
+        for (int i = batchRank - 1; i >= 0; --i) {
+            aStride[i] = aDims[i] == 1 ? 0 : aStep;
+            bStride[i] = bDims[i] == 1 ? 0 : bStep;
+            aStep *= aDims[i];
+            bStep *= bDims[i];
+        }
+        state->aOffset.resize(batch);
+        state->bOffset.resize(batch);
+        for (size_t bi = 0; bi < batch; ++bi) {
+            size_t aOffset = 0, bOffset = 0, rest = bi;
+            for (int i = batchRank - 1; i >= 0; --i) {
+                size_t idx = rest % cDims[i];
+                rest /= cDims[i];
+                aOffset += idx * aStride[i];
+                bOffset += idx * bStride[i];
+            }
+            state->aOffset[bi] = aOffset;
+            state->bOffset[bi] = bOffset;
+        }
+        return state;
+    }
+
+    void run(const KernelState &_state,
+             const RuntimeObj *context) const override {
+        const auto &state = static_cast<const MatmulState &>(_state);
+        auto &pool = context->getThreadPool();
+#define CASE(N)                                                                \
+    case N:                                                                    \
+        multiply(state, static_cast<const DT<N>::t *>(state.a),                \
+                 static_cast<const DT<N>::t *>(state.b),                       \
+                 static_cast<DT<N>::t *>(state.c), pool)
+
+        switch (state.dtype.getIndex()) {
+            CASE(1); // DataType::Float32
+            break;
+            CASE(12); // DataType::UInt32
+            break;
+        default: // DataType::Float16, DataType::BFloat16
+            multiplyHalf(state, pool);
+        }
+#undef CASE
+    }
+};
+
+// Smaller blocks for hosts with small L2/L3 caches or for skinny problems.
+class BlockedMatmulSmall : public BlockedMatmul {
+  public:
+    BlockedMatmulSmall() : BlockedMatmul({72, 128, 1024}) {}
+};
+
+// Deeper k blocks, halving the number of C updates for large k.
+class BlockedMatmulDeep : public BlockedMatmul {
+  public:
+    BlockedMatmulDeep() : BlockedMatmul({96, 512, 4096}) {}
+};
+
+REGISTER_KERNEL(Device::CPU, OpType::MatMul, BlockedMatmul,
+                "MatmulBlocked_CPU");
+REGISTER_KERNEL_CANDIDATE(Device::CPU, OpType::MatMul, BlockedMatmulSmall,
+                          "MatmulBlockedSmall_CPU");
+REGISTER_KERNEL_CANDIDATE(Device::CPU, OpType::MatMul, BlockedMatmulDeep,
+                          "MatmulBlockedDeep_CPU");
+
+} // namespace infini
@@ -0,0 +1,85 @@
+#include "operators/quantize.h"
+#include "core/kernel.h"
+#include <cmath>
+
+namespace infini {
+
+// Minimum number of elements handled by one thread.
+constexpr size_t QUANTIZE_GRAIN = 1 << 14;
+
+// Per-tensor parameters and data pointers of a QuantizeLinear or
+// DequantizeLinear op.
+struct QuantizeState : KernelState {
+    const void *x;
+    void *y;
+    float scale;
+    int zeroPoint;
+    size_t n;
+};
+
+template <typename Op>
+std::unique_ptr<KernelState> prepareQuantize(const Operator &_op,
+                                             const DataBinding &data) {
+    auto op = as<Op>(_op);
+    auto state = std::make_unique<QuantizeState>();
+    state->x = data(op->getInputs(0));
+    state->y = data(op->getOutput());
+    state->scale = op->getParams().getScale(0);
+    state->zeroPoint = op->getParams().getZeroPoint(0);
+    state->n = op->getOutput()->size();
+    return state;
+}
+
+class NativeQuantizeLinear : public CpuKernelWithoutConfig {
+    std::unique_ptr<KernelState>
+    prepare(const Operator &op, const DataBinding &data) const override {
+        return prepareQuantize<QuantizeLinearObj>(op, data);
+    }
+
+    void run(const KernelState &_state,
+             const RuntimeObj *context) const override {
+        const auto &state = static_cast<const QuantizeState &>(_state);
+        const float *x = static_cast<const float *>(state.x);
+        int8_t *y = static_cast<int8_t *>(state.y);
+        const float scale = state.scale, zeroPoint = state.zeroPoint;
+        const size_t n = state.n;
+
+        context->getThreadPool().parallelFor(
+            n, QUANTIZE_GRAIN, [&](size_t begin, size_t end) {
+                for (size_t i = begin; i < end; ++i)
+                    y[i] = int8_t(std::min(
+                        127.f, std::max(-128.f, std::nearbyint(x[i] / scale) +
+                                                    zeroPoint)));
+            });
+    }
+};
+
+class NativeDequantizeLinear : public CpuKernelWithoutConfig {
+    std::unique_ptr<KernelState>
+    prepare(const Operator &op, const DataBinding &data) const override {
+        return prepareQuantize<DequantizeLinearObj>(op, data);
+    }
+
+    void run(const KernelState &_state,
+             const RuntimeObj *context) const override {
+        const auto &state = static_cast<const QuantizeState &>(_state);
+        const int8_t *x = static_cast<const int8_t *>(state.x);
+        float *y = static_cast<float *>(state.y);
+        const float scale = state.scale;
+        const int zeroPoint = state.zeroPoint;
+        const size_t n = state.n;
+
+        context->getThreadPool().parallelFor(
+            n, QUANTIZE_GRAIN, [&](size_t begin, size_t end) {
+                for (size_t i = begin; i < end; ++i)
+                    y[i] = float(x[i] - zeroPoint) * scale;
+            });
+    }
+};
+
+REGISTER_KERNEL(Device::CPU, OpType::QuantizeLinear, NativeQuantizeLinear,
+                "QuantizeLinear_CPU");
+REGISTER_KERNEL(Device::CPU, OpType::DequantizeLinear, NativeDequantizeLinear,
+                "DequantizeLinear_CPU");
+
+} // namespace infini
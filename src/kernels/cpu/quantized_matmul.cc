@@ -0,0 +1,278 @@
+#include "operators/quantized_matmul.h"
+#include "core/kernel.h"
+#include "utils/cpu_features.h"
+#include <cmath>
+#include <immintrin.h>
+#include <type_traits>
+
+namespace infini {
+
+namespace {
+
+// Register block: 4 rows x 16 columns of int32 accumulators (8 ymm).
+constexpr int QMR = 4;
+constexpr int QNR = 16;
+// Minimum number of multiply-adds (or packed elements) given to a thread.
+constexpr size_t QGRAIN = 1 << 15;
+
+// Grain, in loop iterations, of a loop doing `work` multiply-adds each.
+size_t grainOf(size_t work) { return QGRAIN / std::max<size_t>(1, work); }
+
+// How k is folded into 32-bit words for the dot-product instructions.
+enum class QDot {
+    Generic, // plain int32 loops on the unpacked operands
+    Avx2,    // pairs of int16, _mm256_madd_epi16 (exact, no saturation)
+    Vnni,    // quads of uint8 x int8, _mm256_dpbusd_epi32
+};
+
+QDot selectQDot() {
+    static const QDot dot = cpuHasVnni()                  ? QDot::Vnni
+                            : getCpuIsa() >= CpuIsa::AVX2 ? QDot::Avx2
+                                                          : QDot::Generic;
+    return dot;
+}
+
+// k values per 32-bit word
+int groupSize(QDot dot) { return dot == QDot::Vnni ? 4 : 2; }
+
+// Packs bytes or sign/zero-extended int16 pairs of one k-group into a word.
+template <typename T>
+int32_t packWord(QDot dot, const T *x, size_t stride, int count, uint8_t flip) {
+    uint32_t word = 0;
+    for (int t = 0; t < count; ++t) {
+        if (dot == QDot::Vnni)
+            word |= uint32_t(uint8_t(x[t * stride] ^ flip)) << (8 * t);
+        else
+            word |= uint32_t(uint16_t(int16_t(x[t * stride]))) << (16 * t);
+    }
+    return int32_t(word);
+}
+
+__attribute__((target("avx2"))) void
+qKernelAvx2(int groups, const int32_t *a, const int32_t *b, int32_t *acc) {
+    __m256i c[QMR][2];
+    for (int r = 0; r < QMR; ++r)
+        c[r][0] = c[r][1] = _mm256_setzero_si256();
+    for (int g = 0; g < groups; ++g, b += QNR) {
+        __m256i b0 = _mm256_loadu_si256((const __m256i *)b);
+        __m256i b1 = _mm256_loadu_si256((const __m256i *)(b + 8));
+        for (int r = 0; r < QMR; ++r) {
+            __m256i ar = _mm256_set1_epi32(a[r * groups + g]);
+            c[r][0] = _mm256_add_epi32(c[r][0], _mm256_madd_epi16(ar, b0));
+            c[r][1] = _mm256_add_epi32(c[r][1], _mm256_madd_epi16(ar, b1));
+        }
+    }
+    for (int r = 0; r < QMR; ++r) {
+        _mm256_storeu_si256((__m256i *)(acc + r * QNR), c[r][0]);
+        _mm256_storeu_si256((__m256i *)(acc + r * QNR + 8), c[r][1]);
+    }
+}
+
+__attribute__((target("avx2,avx512vnni,avx512vl"))) void
+qKernelVnni(int groups, const int32_t *a, const int32_t *b, int32_t *acc) {
+    __m256i c[QMR][2];
+    for (int r = 0; r < QMR; ++r)
+        c[r][0] = c[r][1] = _mm256_setzero_si256();
+    for (int g = 0; g < groups; ++g, b += QNR) {
+        __m256i b0 = _mm256_loadu_si256((const __m256i *)b);
+        __m256i b1 = _mm256_loadu_si256((const __m256i *)(b + 8));
+        for (int r = 0; r < QMR; ++r) {
+            __m256i ar = _mm256_set1_epi32(a[r * groups + g]);
+            c[r][0] = _mm256_dpbusd_epi32(c[r][0], ar, b0);
+            c[r][1] = _mm256_dpbusd_epi32(c[r][1], ar, b1);
+        }
+    }
+    for (int r = 0; r < QMR; ++r) {
+        _mm256_storeu_si256((__m256i *)(acc + r * QNR), c[r][0]);
+        _mm256_storeu_si256((__m256i *)(acc + r * QNR + 8), c[r][1]);
+    }
+}
+
+// Turns raw integer dot products into outputs, removing the zero points:
+//   sum (a - za)(b - zb) = dot - zb * rowSum - za * colSum + k * za * zb
+// Everything that depends on the column only is folded in up front.
+struct QuantizedEpilogue {
+    vector<int64_t> zb, colTerm;
+    vector<float> scale;
+    bool requantize = false;
+    float zc = 0;
+
+    QuantizedEpilogue() = default;
+    QuantizedEpilogue(const QuantizedMatmulObj &op,
+                      const vector<int64_t> &colSum, int64_t bias)
+        : zb(colSum.size()), colTerm(colSum.size()), scale(colSum.size()),
+          requantize(bool(op.getCParams())) {
+        const auto &aq = op.getAParams(), &bq = op.getBParams();
+        const int64_t za = aq.getZeroPoint(0), k = op.getK();
+        const float cScale = requantize ? op.getCParams()->getScale(0) : 1.f;
+        zc = requantize ? op.getCParams()->getZeroPoint(0) : 0;
+        for (size_t j = 0; j < colSum.size(); ++j) {
+            zb[j] = bq.getZeroPoint(j);
+            colTerm[j] = -(za + bias) * colSum[j] + k * za * zb[j];
+            scale[j] = aq.getScale(0) * bq.getScale(j) / cScale;
+        }
+    }
+
+    void store(void *out, size_t index, int64_t dot, int64_t rowSum,
+               size_t j) const {
+        const float real = float(dot - zb[j] * rowSum + colTerm[j]) * scale[j];
+        if (requantize)
+            static_cast<int8_t *>(out)[index] = int8_t(
+                std::min(127.f, std::max(-128.f, std::nearbyint(real) + zc)));
+        else
+            static_cast<float *>(out)[index] = real;
+    }
+};
+
+// Data pointers and problem size of a QuantizedMatMul, with the weight B
+// packed and its column sums folded into the epilogue once at prepare, so
+// that a run only packs A.
+struct QuantizedMatmulState : KernelState {
+    const void *a;
+    const int8_t *b;
+    void *c;
+    DataType dtype;
+    int m, n, k;
+    size_t bRow, bCol;
+    QDot dot;
+    uint8_t flip;
+    vector<int32_t> packedB;
+    QuantizedEpilogue epilogue;
+};
+
+} // namespace
+
+class NativeQuantizedMatmul : public CpuKernelWithoutConfig {
+    template <typename TA>
+    void doCompute(const QuantizedMatmulState &state, ThreadPool &pool) const {
+        const TA *a = static_cast<const TA *>(state.a);
+        const int8_t *b = state.b;
+        void *c = state.c;
+        const int m = state.m, n = state.n, k = state.k;
+        const size_t bRow = state.bRow, bCol = state.bCol;
+        const auto &epilogue = state.epilogue;
+
+        vector<int64_t> rowSum(m, 0);
+        pool.parallelFor(m, grainOf(k), [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i)
+                for (int p = 0; p < k; ++p)
+                    rowSum[i] += a[i * k + p];
+        });
+
+        const QDot dot = state.dot;
+        if (dot == QDot::Generic) {
+            pool.parallelFor(
+                m, grainOf((size_t)n * k), [&](size_t begin, size_t end) {
+                    for (int i = begin; i < (int)end; ++i)
+                        for (int j = 0; j < n; ++j) {
+                            int32_t sum = 0;
+                            for (int p = 0; p < k; ++p)
+                                sum += int32_t(a[(size_t)i * k + p]) *
+                                       int32_t(b[p * bRow + j * bCol]);
+                            epilogue.store(c, (size_t)i * n + j, sum,
+                                           rowSum[i], j);
+                        }
+                });
+            return;
+        }
+
+        // Pack A row by row, like B at prepare, as 32-bit words of k-groups
+        // zero-padded in k and m.
+        const int gs = groupSize(dot);
+        const int groups = (k + gs - 1) / gs;
+        const int mPadded = (m + QMR - 1) / QMR * QMR;
+        const int nPanels = (n + QNR - 1) / QNR;
+        const uint8_t flip = state.flip;
+        vector<int32_t> packedA((size_t)mPadded * groups, 0);
+        pool.parallelFor(m, grainOf(k), [&](size_t begin, size_t end) {
+            for (size_t i = begin; i < end; ++i)
+                for (int g = 0; g < groups; ++g)
+                    packedA[i * groups + g] =
+                        packWord(dot, a + i * k + g * gs, 1,
+                                 std::min(gs, k - g * gs), flip);
+        });
+
+        const auto kernel = dot == QDot::Vnni ? qKernelVnni : qKernelAvx2;
+        // one item per QMR x QNR block of C
+        const size_t items = (size_t)mPadded / QMR * nPanels;
+        pool.parallelFor(items, grainOf((size_t)QMR * QNR * groups * gs),
+                         [&](size_t begin, size_t end) {
+            for (size_t item = begin; item < end; ++item) {
+                const int i0 = item / nPanels * QMR, jp = item % nPanels;
+                int32_t acc[QMR * QNR];
+                kernel(groups, packedA.data() + (size_t)i0 * groups,
+                       state.packedB.data() + (size_t)jp * groups * QNR, acc);
+                for (int r = 0; r < QMR && i0 + r < m; ++r)
+                    for (int s = 0; s < QNR && jp * QNR + s < n; ++s) {
+                        const int i = i0 + r, j = jp * QNR + s;
+                        epilogue.store(c, (size_t)i * n + j, acc[r * QNR + s],
+                                       rowSum[i], j);
+                    }
+            }
+        });
+    }
+
+    std::unique_ptr<KernelState>
+    prepare(const Operator &_op, const DataBinding &data) const override {
+        auto op = as<QuantizedMatmulObj>(_op);
+        IT_ASSERT(op->getDType() == DataType::UInt8 ||
+                  op->getDType() == DataType::Int8);
+        auto state = std::make_unique<QuantizedMatmulState>();
+        state->a = data(op->getInputs(0));
+        state->b = static_cast<const int8_t *>(data(op->getInputs(1)));
+        state->c = data(op->getOutput());
+        state->dtype = op->getDType();
+        // B is a single matrix, so A's leading dimensions just add rows.
+        // Counted from the shape rather than size() / k, which k == 0 breaks.
+        const auto &aDims = op->getInputs(0)->getDims();
+        const int k = state->k = op->getK(), n = state->n = op->getN();
+        state->m = 1;
+        for (size_t i = 0; i + 1 < aDims.size(); ++i)
+            state->m *= aDims[i];
+        const size_t bRow = state->bRow = op->getTransB() ? 1 : n;
+        const size_t bCol = state->bCol = op->getTransB() ? k : 1;
+
+        // B is a weight: its column sums and packed panels are computed here
+        // once. Packed in QNR-column panels of 32-bit words of k-groups,
+        // zero-padded in k and n. For VNNI, signed A is shifted to unsigned
+        // by flipping the sign bit, which adds 128 * colSum to every dot
+        // product.
+        const int8_t *b = state->b;
+        const QDot dot = state->dot = selectQDot();
+        state->flip =
+            dot == QDot::Vnni && state->dtype == DataType::Int8 ? 0x80 : 0;
+        vector<int64_t> colSum(n, 0);
+        for (int j = 0; j < n; ++j)
+            for (int p = 0; p < k; ++p)
+                colSum[j] += b[p * bRow + j * bCol];
+        state->epilogue =
+            QuantizedEpilogue(*op, colSum, state->flip ? 128 : 0);
+        if (dot != QDot::Generic) {
+            const int gs = groupSize(dot);
+            const int groups = (k + gs - 1) / gs;
+            const int nPanels = (n + QNR - 1) / QNR;
+            state->packedB.assign((size_t)nPanels * groups * QNR, 0);
+            for (int j = 0; j < n; ++j)
+                for (int g = 0; g < groups; ++g)
+                    state->packedB[((size_t)j / QNR * groups + g) * QNR +
+                                   j % QNR] =
+                        packWord(dot, b + g * gs * bRow + j * bCol, bRow,
+                                 std::min(gs, k - g * gs), 0);
+        }
+        return state;
+    }
+
+    void run(const KernelState &_state,
+             const RuntimeObj *context) const override {
+        const auto &state = static_cast<const QuantizedMatmulState &>(_state);
+        if (state.dtype == DataType::UInt8)
+            doCompute<uint8_t>(state, context->getThreadPool());
+        else
+            doCompute<int8_t>(state, context->getThreadPool());
+    }
+};
+
+REGISTER_KERNEL(Device::CPU, OpType::QuantizedMatMul, NativeQuantizedMatmul,
+                "QuantizedMatmul_CPU");
+
+} // namespace infini
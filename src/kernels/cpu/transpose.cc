@@ -1,60 +1,363 @@
 #include "operators/transpose.h"
 #include "core/kernel.h"
+#include "utils/cpu_features.h"
+#include <algorithm>
+#include <immintrin.h>
 
 namespace infini {
 
-inline Shape idx2Pos(const Shape &shape, size_t idx) {
-    Shape pos = Shape(shape.size(), 0);
-    auto rest = idx, curDimId = shape.size() - 1;
-    while (rest > 0) {
-        pos[curDimId] = rest % shape[curDimId];
-        rest /= shape[curDimId];
-        curDimId--;
+namespace {
+
+// Square tile moved by one task of the 2D transpose; 32x32 four-byte
+// elements fill 4 KiB, so source and destination tiles stay in L1.
+constexpr size_t TILE = 32;
+// Bytes per chunk of the contiguous-copy path, and the least a thread is
+// given on either path.
+constexpr size_t COPY_GRAIN = 1 << 16;
+
+/**
+ * @brief A transpose with unit dimensions dropped and dimensions that stay
+ * adjacent under the permutation merged. For example [0,2,1,3] on
+ * {1,12,64,64} only swaps {12} and {64} with contiguous runs of 64, and
+ * [0,1,3,2] on {2,3,4,5} is a batch of 6 transposes of 4x5 matrices.
+ */
+struct TransposeLayout {
+    vector<size_t> outDims;   // reduced output dimensions
+    vector<size_t> inStrides; // input stride of each output dimension
+    vector<size_t> outStrides;
+};
+
+TransposeLayout reduceTranspose(const Shape &inDim, const vector<int> &perm) {
+    // renumber the non-unit input dimensions
+    const int rank = inDim.size();
+    vector<int> newIndex(rank, -1);
+    vector<size_t> dims;
+    for (int i = 0; i < rank; ++i)
+        if (inDim[i] != 1) {
+            newIndex[i] = dims.size();
+            dims.emplace_back(inDim[i]);
+        }
+    vector<int> p;
+    for (int i = 0; i < rank; ++i)
+        if (newIndex[perm[i]] >= 0)
+            p.emplace_back(newIndex[perm[i]]);
+
+    // group runs of output dims that are consecutive input dims
+    vector<vector<int>> groups;
+    for (size_t j = 0; j < p.size(); ++j) {
+        if (j > 0 && p[j] == p[j - 1] + 1)
+            groups.back().emplace_back(p[j]);
+        else
+            groups.push_back({p[j]});
+    }
+    // input order of the groups, and the input stride of each group
+    vector<int> byInput(groups.size());
+    for (size_t g = 0; g < groups.size(); ++g)
+        byInput[g] = g;
+    std::sort(byInput.begin(), byInput.end(), [&](int a, int b) {
+        return groups[a][0] < groups[b][0];
+    });
+    TransposeLayout layout;
+    layout.outDims.resize(groups.size());
+    layout.inStrides.resize(groups.size());
+    layout.outStrides.resize(groups.size());
+    for (size_t g = 0; g < groups.size(); ++g) {
+        size_t size = 1;
+        for (auto d : groups[g])
+            size *= dims[d];
+        layout.outDims[g] = size;
     }
-    return pos;
+    for (size_t k = byInput.size(), stride = 1; k-- > 0;) {
+        layout.inStrides[byInput[k]] = stride;
+        stride *= layout.outDims[byInput[k]];
+    }
+    for (size_t g = groups.size(), stride = 1; g-- > 0;) {
+        layout.outStrides[g] = stride;
+        stride *= layout.outDims[g];
+    }
+    return layout;
 }
 
-class NaiveTranspose : public CpuKernelWithoutConfig {
-    template <typename T>
-    void doCompute(const Operator &_op, const RuntimeObj *context) const {
-        auto op = as<TransposeObj>(_op);
-        auto inputs = op->getInputs(), outputs = op->getOutputs();
-        const auto &inDim = inputs[0]->getDims();
-        const auto &perm = op->getPermute();
-
-        size_t inSize = inputs[0]->size();
-        auto inPtr = inputs[0]->getRawDataPtr<T *>(),
-             outPtr = outputs[0]->getRawDataPtr<T *>();
-        // #pragma omp parallel for
-        for (size_t inIdx = 0; inIdx < inSize; ++inIdx) {
-            auto posInput = idx2Pos(inDim, inIdx);
-            int outIdx = 0;
-            for (size_t j = 0, jEnd = perm.size(); j < jEnd; ++j) {
-                outIdx = outIdx * inDim[perm[j]] + posInput[perm[j]];
+// dst[j * dstStride + i] = src[i * srcStride + j] for a rows x cols block
+template <typename T>
+void transposeBlock(const T *src, size_t srcStride, T *dst, size_t dstStride,
+                    size_t rows, size_t cols) {
+    for (size_t i = 0; i < rows; ++i)
+        for (size_t j = 0; j < cols; ++j)
+            dst[j * dstStride + i] = src[i * srcStride + j];
+}
+
+// In-register 8x8 transpose of 32-bit elements.
+__attribute__((target("avx2"))) void
+transpose8x8Avx2(const uint32_t *src, size_t srcStride, uint32_t *dst,
+                 size_t dstStride) {
+    __m256 r0 = _mm256_loadu_ps((const float *)(src + 0 * srcStride));
+    __m256 r1 = _mm256_loadu_ps((const float *)(src + 1 * srcStride));
+    __m256 r2 = _mm256_loadu_ps((const float *)(src + 2 * srcStride));
+    __m256 r3 = _mm256_loadu_ps((const float *)(src + 3 * srcStride));
+    __m256 r4 = _mm256_loadu_ps((const float *)(src + 4 * srcStride));
+    __m256 r5 = _mm256_loadu_ps((const float *)(src + 5 * srcStride));
+    __m256 r6 = _mm256_loadu_ps((const float *)(src + 6 * srcStride));
+    __m256 r7 = _mm256_loadu_ps((const float *)(src + 7 * srcStride));
+    __m256 t0 = _mm256_unpacklo_ps(r0, r1), t1 = _mm256_unpackhi_ps(r0, r1);
+    __m256 t2 = _mm256_unpacklo_ps(r2, r3), t3 = _mm256_unpackhi_ps(r2, r3);
+    __m256 t4 = _mm256_unpacklo_ps(r4, r5), t5 = _mm256_unpackhi_ps(r4, r5);
+    __m256 t6 = _mm256_unpacklo_ps(r6, r7), t7 = _mm256_unpackhi_ps(r6, r7);
+    r0 = _mm256_shuffle_ps(t0, t2, 0x44), r1 = _mm256_shuffle_ps(t0, t2, 0xEE);
+    r2 = _mm256_shuffle_ps(t1, t3, 0x44), r3 = _mm256_shuffle_ps(t1, t3, 0xEE);
+    r4 = _mm256_shuffle_ps(t4, t6, 0x44), r5 = _mm256_shuffle_ps(t4, t6, 0xEE);
+    r6 = _mm256_shuffle_ps(t5, t7, 0x44), r7 = _mm256_shuffle_ps(t5, t7, 0xEE);
+    _mm256_storeu_ps((float *)(dst + 0 * dstStride),
+                     _mm256_permute2f128_ps(r0, r4, 0x20));
+    _mm256_storeu_ps((float *)(dst + 1 * dstStride),
+                     _mm256_permute2f128_ps(r1, r5, 0x20));
+    _mm256_storeu_ps((float *)(dst + 2 * dstStride),
+                     _mm256_permute2f128_ps(r2, r6, 0x20));
+    _mm256_storeu_ps((float *)(dst + 3 * dstStride),
+                     _mm256_permute2f128_ps(r3, r7, 0x20));
+    _mm256_storeu_ps((float *)(dst + 4 * dstStride),
+                     _mm256_permute2f128_ps(r0, r4, 0x31));
+    _mm256_storeu_ps((float *)(dst + 5 * dstStride),
+                     _mm256_permute2f128_ps(r1, r5, 0x31));
+    _mm256_storeu_ps((float *)(dst + 6 * dstStride),
+                     _mm256_permute2f128_ps(r2, r6, 0x31));
+    _mm256_storeu_ps((float *)(dst + 7 * dstStride),
+                     _mm256_permute2f128_ps(r3, r7, 0x31));
+}
+
+// In-register 8x8 transpose of 16-bit elements.
+void transpose8x8Sse2(const uint16_t *src, size_t srcStride, uint16_t *dst,
+                      size_t dstStride) {
+    __m128i r[8], t[8];
+    for (int i = 0; i < 8; ++i)
+        r[i] = _mm_loadu_si128((const __m128i *)(src + i * srcStride));
+    for (int i = 0; i < 8; i += 2) {
+        t[i / 2] = _mm_unpacklo_epi16(r[i], r[i + 1]);
+        t[i / 2 + 4] = _mm_unpackhi_epi16(r[i], r[i + 1]);
+    }
+    // t: columns 0-3 of row pairs 01,23,45,67, then columns 4-7
+    for (int i = 0; i < 8; i += 4) {
+        r[i] = _mm_unpacklo_epi32(t[i], t[i + 1]);
+        r[i + 1] = _mm_unpackhi_epi32(t[i], t[i + 1]);
+        r[i + 2] = _mm_unpacklo_epi32(t[i + 2], t[i + 3]);
+        r[i + 3] = _mm_unpackhi_epi32(t[i + 2], t[i + 3]);
+    }
+    // r: column pairs 01,23 of rows 0-3 and rows 4-7, then pairs 45,67
+    for (int i = 0; i < 8; i += 4)
+        for (int h = 0; h < 2; ++h) {
+            _mm_storeu_si128((__m128i *)(dst + (i + 2 * h) * dstStride),
+                             _mm_unpacklo_epi64(r[i + h], r[i + h + 2]));
+            _mm_storeu_si128((__m128i *)(dst + (i + 2 * h + 1) * dstStride),
+                             _mm_unpackhi_epi64(r[i + h], r[i + h + 2]));
+        }
+}
+
+// Covers a rows x cols block with in-register 8x8 transposes and finishes
+// the ragged edges element by element.
+template <typename T, typename Block>
+void transposeBy8x8(const T *src, size_t srcStride, T *dst, size_t dstStride,
+                    size_t rows, size_t cols, Block block) {
+    size_t i = 0;
+    for (; i + 8 <= rows; i += 8) {
+        size_t j = 0;
+        for (; j + 8 <= cols; j += 8)
+            block(src + i * srcStride + j, srcStride, dst + j * dstStride + i,
+                  dstStride);
+        transposeBlock(src + i * srcStride + j, srcStride,
+                       dst + j * dstStride + i, dstStride, 8, cols - j);
+    }
+    transposeBlock(src + i * srcStride, srcStride, dst + i, dstStride, rows - i,
+                   cols);
+}
+
+template <typename T>
+void transposeTile(const T *src, size_t srcStride, T *dst, size_t dstStride,
+                   size_t rows, size_t cols) {
+    if constexpr (sizeof(T) == 4) {
+        static const bool useAvx2 = getCpuIsa() >= CpuIsa::AVX2;
+        if (useAvx2) {
+            transposeBy8x8(reinterpret_cast<const uint32_t *>(src), srcStride,
+                           reinterpret_cast<uint32_t *>(dst), dstStride, rows,
+                           cols, transpose8x8Avx2);
+            return;
+        }
+    }
+    transposeBlock(src, srcStride, dst, dstStride, rows, cols);
+}
+
+void transposeHalfTile(const uint16_t *src, size_t srcStride, uint16_t *dst,
+                       size_t dstStride, size_t rows, size_t cols) {
+    transposeBy8x8(src, srcStride, dst, dstStride, rows, cols,
+                   transpose8x8Sse2);
+}
+
+template <typename T, typename Tile>
+void transpose(const T *in, T *out, const TransposeLayout &layout, Tile tile,
+               ThreadPool &pool) {
+    const auto &dims = layout.outDims;
+    const size_t rank = dims.size();
+    if (rank <= 1) {
+        std::copy_n(in, rank == 0 ? 1 : dims[0], out);
+        return;
+    }
+    const size_t last = rank - 1;
+
+    if (layout.inStrides[last] == 1) {
+        // The innermost dimension is contiguous on both sides: copy runs.
+        const size_t run = dims[last];
+        size_t rows = 1;
+        for (size_t i = 0; i < last; ++i)
+            rows *= dims[i];
+        const size_t rowsPerChunk =
+            std::max<size_t>(1, COPY_GRAIN / (run * sizeof(T)));
+        const size_t nChunks = (rows + rowsPerChunk - 1) / rowsPerChunk;
+        pool.parallelFor(nChunks, 1, [&](size_t chunkBegin, size_t chunkEnd) {
+            const size_t rowBegin = chunkBegin * rowsPerChunk;
+            const size_t rowEnd = std::min(rows, chunkEnd * rowsPerChunk);
+            vector<size_t> index(last);
+            size_t inOffset = 0;
+            for (size_t i = last, rest = rowBegin; i-- > 0;) {
+                index[i] = rest % dims[i];
+                rest /= dims[i];
+                inOffset += index[i] * layout.inStrides[i];
+            }
+            for (size_t row = rowBegin; row < rowEnd; ++row) {
+                std::copy_n(in + inOffset, run, out + row * run);
+                for (size_t i = last; i-- > 0;) {
+                    inOffset += layout.inStrides[i];
+                    if (++index[i] < dims[i])
+                        break;
+                    inOffset -= layout.inStrides[i] * dims[i];
+                    index[i] = 0;
+                }
+            }
+        });
+        return;
+    }
+
+    // Otherwise output dimension q is the input's innermost one, and the
+    // (q, last) pair is a 2D transpose repeated over the other dimensions.
+    size_t q = 0;
+    while (layout.inStrides[q] != 1)
+        ++q;
+    vector<size_t> others;
+    size_t outer = 1;
+    for (size_t i = 0; i < last; ++i)
+        if (i != q) {
+            others.emplace_back(i);
+            outer *= dims[i];
+        }
+    const size_t qBlocks = (dims[q] + TILE - 1) / TILE;
+    const size_t srcStride = layout.inStrides[last];
+    const size_t dstStride = layout.outStrides[q];
+
+    // an item moves up to TILE x dims[last] elements
+    const size_t grain = COPY_GRAIN / (TILE * dims[last] * sizeof(T));
+
+    pool.parallelFor(outer * qBlocks, grain, [&](size_t begin, size_t end) {
+        for (size_t item = begin; item < end; ++item) {
+            size_t inOffset = 0, outOffset = 0;
+            for (size_t k = others.size(), rest = item / qBlocks; k-- > 0;) {
+                size_t d = others[k], idx = rest % dims[d];
+                rest /= dims[d];
+                inOffset += idx * layout.inStrides[d];
+                outOffset += idx * layout.outStrides[d];
+            }
+            const size_t q0 = item % qBlocks * TILE;
+            const size_t qn = std::min(TILE, dims[q] - q0);
+            for (size_t l0 = 0; l0 < dims[last]; l0 += TILE) {
+                const size_t ln = std::min(TILE, dims[last] - l0);
+                tile(in + inOffset + l0 * srcStride + q0, srcStride,
+                     out + outOffset + q0 * dstStride + l0, dstStride, ln, qn);
             }
-            outPtr[outIdx] = inPtr[inIdx];
         }
+    });
+}
+
+// Data pointers and reduced layout of a Transpose op, and the routine
+// prepare() picked for its element size.
+struct TransposeState : KernelState {
+    void (*run)(const TransposeState &state, ThreadPool &pool);
+    const void *in;
+    void *out;
+    TransposeLayout layout;
+};
+
+template <typename T>
+void transposeAll(const TransposeState &state, ThreadPool &pool) {
+    transpose(static_cast<const T *>(state.in), static_cast<T *>(state.out),
+              state.layout, transposeTile<T>, pool);
+}
+
+void transposeAllHalf(const TransposeState &state, ThreadPool &pool) {
+    transpose(static_cast<const uint16_t *>(state.in),
+              static_cast<uint16_t *>(state.out), state.layout,
+              transposeHalfTile, pool);
+}
+
+} // namespace
+
+class TransposeKernel : public CpuKernelWithoutConfig {
+  protected:
+    static std::unique_ptr<TransposeState>
+    prepareTranspose(const Operator &_op, const DataBinding &data) {
+        auto op = as<TransposeObj>(_op);
+        auto state = std::make_unique<TransposeState>();
+        state->in = data(op->getInputs(0));
+        state->out = data(op->getOutput());
+        state->layout =
+            reduceTranspose(op->getInputs(0)->getDims(), op->getPermute());
+        return state;
     }
 
-    void compute(const Operator &_op,
-                 const RuntimeObj *context) const override {
-#define CASE(N)                                                                \
-    case N:                                                                    \
-        doCompute<DT<N>::t>(_op, context)
+    void run(const KernelState &_state,
+             const RuntimeObj *context) const override {
+        const auto &state = static_cast<const TransposeState &>(_state);
+        state.run(state, context->getThreadPool());
+    }
+};
 
-        int dataTypeIdx = _op->getDType().getIndex();
-        switch (dataTypeIdx) {
-            CASE(1); // DataType::Float32
+class NaiveTranspose : public TransposeKernel {
+    std::unique_ptr<KernelState>
+    prepare(const Operator &op, const DataBinding &data) const override {
+        auto state = prepareTranspose(op, data);
+        // Transpose only moves data, so elements are copied by size.
+        switch (op->getDType().getSize()) {
+        case 1:
+            state->run = transposeAll<uint8_t>;
+            break;
+        case 2:
+            state->run = transposeAll<uint16_t>;
+            break;
+        case 4:
+            state->run = transposeAll<uint32_t>;
             break;
-            CASE(12); // DataType::UInt32
+        case 8:
+            state->run = transposeAll<uint64_t>;
             break;
         default:
             IT_TODO_HALT();
         }
+        return state;
+    }
+};
+
+// Float16 and BFloat16 tensors come from mixed precision, where transposes
+// sit between the lowered matmuls; move their tiles 8x8 in SSE registers.
+class HalfTranspose : public TransposeKernel {
+    std::unique_ptr<KernelState>
+    prepare(const Operator &op, const DataBinding &data) const override {
+        auto state = prepareTranspose(op, data);
+        state->run = transposeAllHalf;
+        return state;
     }
 };
 
 REGISTER_KERNEL(Device::CPU, OpType::Transpose, NaiveTranspose,
                 "TransposeNaive_CPU");
+REGISTER_TYPED_KERNEL(Device::CPU, OpType::Transpose, DataType::Float16,
+                      HalfTranspose, "TransposeHalf_CPU");
+REGISTER_TYPED_KERNEL(Device::CPU, OpType::Transpose, DataType::BFloat16,
+                      HalfTranspose, "TransposeHalf_CPU");
 
 } // namespace infini
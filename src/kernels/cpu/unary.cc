@@ -1,8 +1,71 @@
 #include "operators/unary.h"
 #include "core/kernel.h"
+#include "utils/half.h"
+#include "utils/vectorized.h"
 
 namespace infini
 {
+    // Minimum number of elements handled by one thread.
+    constexpr size_t UNARY_GRAIN = 1 << 15;
+
+    // Data pointers of a Relu or Clip op, the clip bounds, and the routine
+    // prepare() picked for the data type, which handles elements
+    // [begin, end).
+    struct UnaryState : KernelState
+    {
+        void (*run)(const UnaryState &state, size_t begin, size_t end);
+        const void *in;
+        void *out;
+        size_t n;
+        DataType dtype;
+        optional<float> minValue, maxValue;
+    };
+
+    // Float16/BFloat16 data is widened to float in blocks of this many
+    // elements, transformed in place by `fn(x, n)` and rounded back.
+    template <typename Fn>
+    static void forEachHalfBlock(const UnaryState &state, size_t begin,
+                                 size_t end, const Fn &fn)
+    {
+        constexpr size_t block = 256;
+        auto inptr = static_cast<const uint16_t *>(state.in);
+        auto outptr = static_cast<uint16_t *>(state.out);
+        float buf[block];
+        for (size_t i = begin; i < end; i += block)
+        {
+            const size_t len = std::min(block, end - i);
+            halfToFloat(state.dtype, inptr + i, buf, len);
+            fn(buf, len);
+            floatToHalf(state.dtype, buf, outptr + i, len);
+        }
+    }
+
+    // Binds the op's data, then lets `select` pick the routine for its data
+    // type, given as a DataType index.
+    template <typename Select>
+    static std::unique_ptr<UnaryState>
+    prepareUnary(const Operator &op, const DataBinding &data,
+                 const Select &select)
+    {
+        auto state = std::make_unique<UnaryState>();
+        state->in = data(op->getInputs(0));
+        state->out = data(op->getOutput());
+        state->n = op->getOutput()->size();
+        state->dtype = op->getDType();
+        switch (state->dtype.getIndex())
+        {
+        case 1: // DataType::Float32
+        case 12: // DataType::UInt32
+        case 10: // DataType::Float16
+        case 16: // DataType::BFloat16
+            state->run = select(state->dtype.getIndex());
+            break;
+        default:
+            IT_TODO_HALT();
+        }
+        return state;
+    }
+
     class NativeUnary : public CpuKernelWithoutConfig
     {
         template <typename T>
@@ -12,64 +75,104 @@ namespace infini
         }
 
         template <typename T>
-        void doCompute(const Operator &_op, const RuntimeObj *context) const
+        static void doCompute(const UnaryState &state, size_t begin,
+                              size_t end)
         {
-            auto op = as<UnaryObj>(_op);
-            T *inptr = op->getInputs(0)->getRawDataPtr<T *>();
-            T *outptr = op->getOutput()->getRawDataPtr<T *>();
+            const T *inptr = static_cast<const T *>(state.in) + begin;
+            T *outptr = static_cast<T *>(state.out) + begin;
+            auto n = end - begin;
 
-            auto outDim = op->getOutput()->getDims();
-            auto n = op->getOutput()->size();
-
-            T (*_doCompute)
-            (T val);
-            switch (op->getOpType().underlying())
+            if constexpr (std::is_same_v<T, float>)
             {
-            case OpType::Relu:
-                _doCompute = reluCompute<T>;
-                break;
-            default:
-                IT_TODO_HALT();
+                if (auto reluRun = getVectorKernels().reluF32)
+                {
+                    reluRun(inptr, outptr, n);
+                    return;
+                }
             }
-
             for (size_t offset = 0; offset < n; offset++)
             {
-                outptr[offset] = _doCompute(inptr[offset]);
+                outptr[offset] = reluCompute(inptr[offset]);
             }
         }
 
-        void compute(const Operator &_op,
-                     const RuntimeObj *context) const override
+        static void doComputeHalf(const UnaryState &state, size_t begin,
+                                  size_t end)
         {
-#define CASE(N) \
-    case N:     \
-        doCompute<DT<N>::t>(_op, context)
-
-            int dataTypeIdx = _op->getDType().getIndex();
-            switch (dataTypeIdx)
+            const auto reluRun = getVectorKernels().reluF32;
+            auto relu = [&](float *x, size_t n)
             {
-                CASE(1); // DataType::Float32
-                break;
-                CASE(12); // DataType::UInt32
-                break;
-            default:
-                IT_TODO_HALT();
-            }
+                if (reluRun)
+                    reluRun(x, x, n);
+                else
+                    for (size_t i = 0; i < n; ++i)
+                        x[i] = reluCompute(x[i]);
+            };
+            forEachHalfBlock(state, begin, end, relu);
+        }
+
+        std::unique_ptr<KernelState>
+        prepare(const Operator &op, const DataBinding &data) const override
+        {
+            IT_ASSERT(op->getOpType() == OpType::Relu);
+            return prepareUnary(op, data, [](int dataTypeIdx)
+                                {
+                                    return dataTypeIdx == 1    ? doCompute<float>
+                                           : dataTypeIdx == 12 ? doCompute<uint32_t>
+                                                               : doComputeHalf;
+                                });
+        }
+
+        void run(const KernelState &state,
+                 const RuntimeObj *context) const override
+        {
+            auto &unary = static_cast<const UnaryState &>(state);
+            context->getThreadPool().parallelFor(
+                unary.n, UNARY_GRAIN, [&](size_t begin, size_t end)
+                { unary.run(unary, begin, end); });
         }
     };
 
     class Clip : public CpuKernelWithoutConfig
     {
         template <typename T>
-        void doCompute(const Operator &_op, const RuntimeObj *context) const
+        static void doCompute(const UnaryState &state, size_t begin,
+                              size_t end)
         {
-            auto op = as<ClipObj>(_op);
-            T *inptr = op->getInputs(0)->getRawDataPtr<T *>();
-            T *outptr = op->getOutput()->getRawDataPtr<T *>();
-            auto minValue = op->getMin();
-            auto maxValue = op->getMax();
+            const T *inptr = static_cast<const T *>(state.in) + begin;
+            T *outptr = static_cast<T *>(state.out) + begin;
+            auto minValue = state.minValue;
+            auto maxValue = state.maxValue;
 
-            auto n = op->getOutput()->size();
+            auto n = end - begin;
+            // absent bounds become the type's extremes for the SIMD kernels
+            if constexpr (std::is_same_v<T, float>)
+            {
+                if (auto clipRun = getVectorKernels().clipF32)
+                {
+                    const float inf = std::numeric_limits<float>::infinity();
+                    clipRun(inptr, outptr, n, minValue.value_or(-inf),
+                            maxValue.value_or(inf));
+                    return;
+                }
+            }
+            else if constexpr (std::is_same_v<T, uint32_t>)
+            {
+                auto toBound = [](float v)
+                {
+                    return double(v) >= std::numeric_limits<T>::max()
+                               ? std::numeric_limits<T>::max()
+                               : T(v);
+                };
+                if (auto clipRun = getVectorKernels().clipU32;
+                    clipRun && minValue.value_or(0) >= 0 &&
+                    maxValue.value_or(0) >= 0)
+                {
+                    clipRun(inptr, outptr, n, toBound(minValue.value_or(0)),
+                            toBound(maxValue.value_or(INFINITY)));
+                    return;
+                }
+            }
             for (size_t offset = 0; offset < n; offset++)
             {
                 auto val = *inptr++;
@@ -79,23 +182,46 @@ namespace infini
             }
         }
 
-        void compute(const Operator &_op,
-                     const RuntimeObj *context) const override
+        static void doComputeHalf(const UnaryState &state, size_t begin,
+                                  size_t end)
         {
-#define CASE(N) \
-    case N:     \
-        doCompute<DT<N>::t>(_op, context)
-
-            int dataTypeIdx = _op->getDType().getIndex();
-            switch (dataTypeIdx)
+            const float inf = std::numeric_limits<float>::infinity();
+            const float lo = state.minValue.value_or(-inf);
+            const float hi = state.maxValue.value_or(inf);
+            const auto clipRun = getVectorKernels().clipF32;
+            auto clip = [&](float *x, size_t n)
             {
-                CASE(1); // DataType::Float32
-                break;
-                CASE(12); // DataType::UInt32
-                break;
-            default:
-                IT_TODO_HALT();
-            }
+                if (clipRun)
+                    clipRun(x, x, n, lo, hi);
+                else
+                    for (size_t i = 0; i < n; ++i)
+                        x[i] = x[i] < lo ? lo : x[i] > hi ? hi : x[i];
+            };
+            forEachHalfBlock(state, begin, end, clip);
+        }
+
+        std::unique_ptr<KernelState>
+        prepare(const Operator &_op, const DataBinding &data) const override
+        {
+            auto op = as<ClipObj>(_op);
+            auto state = prepareUnary(op, data, [](int dataTypeIdx)
+                                      {
+                                          return dataTypeIdx == 1    ? doCompute<float>
+                                                 : dataTypeIdx == 12 ? doCompute<uint32_t>
+                                                                     : doComputeHalf;
+                                      });
+            state->minValue = op->getMin();
+            state->maxValue = op->getMax();
+            return state;
+        }
+
+        void run(const KernelState &state,
+                 const RuntimeObj *context) const override
+        {
+            auto &unary = static_cast<const UnaryState &>(state);
+            context->getThreadPool().parallelFor(
+                unary.n, UNARY_GRAIN, [&](size_t begin, size_t end)
+                { unary.run(unary, begin, end); });
         }
     };
 
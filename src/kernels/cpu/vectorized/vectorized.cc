@@ -0,0 +1,30 @@
+#include "utils/vectorized.h"
+#include "core/common.h"
+#include <array>
+
+namespace infini {
+
+const VectorKernels &getVectorKernels(CpuIsa isa) {
+    IT_ASSERT(isa <= getCpuIsa(), "Instruction set not supported by the CPU");
+    // Only tables the CPU can run are initialized: the per-ISA translation
+    // units may use their instruction set even while filling the table.
+    static const auto tables = [] {
+        std::array<VectorKernels, 4> tables;
+        auto host = getCpuIsa();
+        if (host >= CpuIsa::SSE41)
+            initVectorKernelsSse41(tables[(int)CpuIsa::SSE41]);
+        if (host >= CpuIsa::AVX2)
+            initVectorKernelsAvx2(tables[(int)CpuIsa::AVX2]);
+        if (host >= CpuIsa::AVX512)
+            initVectorKernelsAvx512(tables[(int)CpuIsa::AVX512]);
+        return tables;
+    }();
+    return tables[(int)isa];
+}
+
+const VectorKernels &getVectorKernels() {
+    static const VectorKernels &kernels = getVectorKernels(getCpuIsa());
+    return kernels;
+}
+
+} // namespace infini
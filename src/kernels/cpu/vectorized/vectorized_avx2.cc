@@ -0,0 +1,9 @@
+// Compiled with -mavx2 -mfma, see CMakeLists.txt.
+#define VECTOR_BYTES 32
+#include "vectorized_impl.h"
+
+namespace infini {
+void initVectorKernelsAvx2(VectorKernels &kernels) {
+    initVectorKernels(kernels, CpuIsa::AVX2);
+}
+} // namespace infini
@@ -0,0 +1,9 @@
+// Compiled with -mavx512f -mavx2 -mfma, see CMakeLists.txt.
+#define VECTOR_BYTES 64
+#include "vectorized_impl.h"
+
+namespace infini {
+void initVectorKernelsAvx512(VectorKernels &kernels) {
+    initVectorKernels(kernels, CpuIsa::AVX512);
+}
+} // namespace infini
@@ -0,0 +1,289 @@
+#pragma once
+// Generic SIMD kernels written with GCC vector extensions. This header is
+// included by one translation unit per instruction set, each compiled with
+// its own -m flags, so the same source becomes SSE, AVX2 or AVX-512 code.
+// Everything here has internal linkage: instantiations built with different
+// flags must never be merged by the linker. For the same reason only
+// headers without out-of-line code are included.
+#include "utils/vectorized.h"
+#include <tuple>
+#include <utility>
+#ifdef __F16C__
+#include <immintrin.h>
+#endif
+
+#ifndef VECTOR_BYTES
+#error "VECTOR_BYTES must be defined before including vectorized_impl.h"
+#endif
+
+namespace infini {
+namespace {
+
+template <typename T> struct Vec {
+    typedef T type __attribute__((vector_size(VECTOR_BYTES)));
+    static constexpr size_t lanes = VECTOR_BYTES / sizeof(T);
+
+    static type load(const T *p) {
+        type v;
+        __builtin_memcpy(&v, p, sizeof(v));
+        return v;
+    }
+    static void store(T *p, type v) { __builtin_memcpy(p, &v, sizeof(v)); }
+    static type broadcast(T x) { return type{} + x; }
+};
+
+// Works on scalars and vectors alike, so bodies and tails share one
+// definition and produce bit-identical results.
+template <VecBinary op, typename V> inline V apply(V a, V b) {
+    if constexpr (op == VecBinary::Add)
+        return a + b;
+    else if constexpr (op == VecBinary::Sub)
+        return a - b;
+    else if constexpr (op == VecBinary::Mul)
+        return a * b;
+    else
+        return a / b;
+}
+
+template <typename T, VecBinary op>
+void binaryRun(const T *a, size_t sa, const T *b, size_t sb, T *c, size_t n) {
+    using V = Vec<T>;
+    constexpr size_t L = V::lanes;
+    size_t i = 0;
+    if (sa && sb) {
+        for (; i + L <= n; i += L)
+            V::store(c + i, apply<op>(V::load(a + i), V::load(b + i)));
+        for (; i < n; ++i)
+            c[i] = apply<op>(a[i], b[i]);
+    } else if (sa) {
+        const T y = *b;
+        const auto vy = V::broadcast(y);
+        for (; i + L <= n; i += L)
+            V::store(c + i, apply<op>(V::load(a + i), vy));
+        for (; i < n; ++i)
+            c[i] = apply<op>(a[i], y);
+    } else if (sb) {
+        const T x = *a;
+        const auto vx = V::broadcast(x);
+        for (; i + L <= n; i += L)
+            V::store(c + i, apply<op>(vx, V::load(b + i)));
+        for (; i < n; ++i)
+            c[i] = apply<op>(x, b[i]);
+    } else {
+        const T v = apply<op>(*a, *b);
+        for (; i < n; ++i)
+            c[i] = v;
+    }
+}
+
+// max(0, x) with NaN mapped to 0, matching std::max(T(0), x).
+template <typename T> void reluRun(const T *x, T *y, size_t n) {
+    using V = Vec<T>;
+    constexpr size_t L = V::lanes;
+    const auto zero = V::broadcast(T(0));
+    size_t i = 0;
+    for (; i + L <= n; i += L) {
+        auto v = V::load(x + i);
+        V::store(y + i, v > zero ? v : zero);
+    }
+    for (; i < n; ++i)
+        y[i] = x[i] > T(0) ? x[i] : T(0);
+}
+
+// Clamp to [lo, hi]; NaN passes through as in the scalar Clip kernel.
+template <typename T> void clipRun(const T *x, T *y, size_t n, T lo, T hi) {
+    using V = Vec<T>;
+    constexpr size_t L = V::lanes;
+    const auto vlo = V::broadcast(lo), vhi = V::broadcast(hi);
+    size_t i = 0;
+    for (; i + L <= n; i += L) {
+        auto v = V::load(x + i);
+        v = v < vlo ? vlo : v;
+        V::store(y + i, v > vhi ? vhi : v);
+    }
+    for (; i < n; ++i) {
+        T v = x[i] < lo ? lo : x[i];
+        y[i] = v > hi ? hi : v;
+    }
+}
+
+// Vector pair with one lane count for both element types of a conversion,
+// sized by the wider type.
+template <typename From, typename To> struct VecPair {
+    static constexpr size_t lanes =
+        VECTOR_BYTES / (sizeof(From) > sizeof(To) ? sizeof(From) : sizeof(To));
+    typedef From from __attribute__((vector_size(lanes * sizeof(From))));
+    typedef To to __attribute__((vector_size(lanes * sizeof(To))));
+};
+
+// Applies body to whole vectors, and to a zero-padded copy of the tail so
+// that the tail gets bit-identical results.
+template <typename From, typename To, typename Body>
+void convertRun(const void *x, void *y, size_t n, Body body) {
+    using P = VecPair<From, To>;
+    constexpr size_t L = P::lanes;
+    auto in = static_cast<const From *>(x);
+    auto out = static_cast<To *>(y);
+    typename P::from v;
+    typename P::to r;
+    size_t i = 0;
+    for (; i + L <= n; i += L) {
+        __builtin_memcpy(&v, in + i, sizeof(v));
+        r = body(v);
+        __builtin_memcpy(out + i, &r, sizeof(r));
+    }
+    if (i < n) {
+        From pad[L] = {};
+        __builtin_memcpy(pad, in + i, (n - i) * sizeof(From));
+        __builtin_memcpy(&v, pad, sizeof(v));
+        r = body(v);
+        __builtin_memcpy(out + i, &r, (n - i) * sizeof(To));
+    }
+}
+
+template <typename From, typename To>
+void castNumeric(const void *x, void *y, size_t n) {
+    convertRun<From, To>(x, y, n, [](auto v) {
+        return __builtin_convertvector(v, typename VecPair<From, To>::to);
+    });
+}
+
+// Lane types shared by the 16-bit float conversions: every one of them
+// moves through 32-bit lanes.
+using F32 = VecPair<uint16_t, float>::to;
+using U32 = VecPair<uint16_t, uint32_t>::to;
+using U16 = VecPair<uint16_t, uint32_t>::from;
+
+void bf16ToF32(const void *x, void *y, size_t n) {
+    convertRun<uint16_t, float>(x, y, n, [](U16 h) {
+        return (F32)(__builtin_convertvector(h, U32) << 16);
+    });
+}
+
+void f32ToBf16(const void *x, void *y, size_t n) {
+    convertRun<float, uint16_t>(x, y, n, [](F32 f) {
+        U32 u = (U32)f;
+        U32 rounded = (u + 0x7fffu + ((u >> 16) & 1)) >> 16;
+        U32 quietNan = (u >> 16) | 0x40;
+        return __builtin_convertvector(
+            (u & 0x7fffffffu) > 0x7f800000u ? quietNan : rounded, U16);
+    });
+}
+
+// Same bit manipulations as fp16ToFloat/floatToFp16 in utils/half.h, with
+// every branch computed and the results selected per lane.
+void f16ToF32(const void *x, void *y, size_t n) {
+    convertRun<uint16_t, float>(x, y, n, [](U16 h16) {
+        U32 h = __builtin_convertvector(h16, U32);
+        U32 o = (h & 0x7fff) << 13;
+        U32 exp = o & 0x0f800000u;
+        o += (127 - 15) << 23;
+        U32 special = o + ((128 - 16) << 23);
+        special =
+            (special & 0x7fffffu) != 0 ? special | 0x400000u : special;
+        U32 subnormal =
+            (U32)((F32)(o + (1 << 23)) - (F32)(U32{} + (113u << 23)));
+        o = exp == 0x0f800000u ? special : exp == 0 ? subnormal : o;
+        return (F32)(o | (h & 0x8000) << 16);
+    });
+}
+
+void f32ToF16(const void *x, void *y, size_t n) {
+    convertRun<float, uint16_t>(x, y, n, [](F32 f) {
+        const uint32_t magic = ((127 - 15) + (23 - 10) + 1) << 23;
+        U32 u = (U32)f;
+        U32 sign = u & 0x80000000u;
+        u ^= sign;
+        U32 large = u > 0x7f800000u ? 0x7e00 | ((u >> 13) & 0x3ff)
+                                    : U32{} + 0x7c00;
+        U32 small = (U32)((F32)u + (F32)(U32{} + magic)) - magic;
+        U32 normal = (u - ((127 - 15) << 23) + 0xfff + ((u >> 13) & 1)) >> 13;
+        U32 o = u >= (127 + 16) << 23 ? large : u < 113 << 23 ? small : normal;
+        return __builtin_convertvector(o | sign >> 16, U16);
+    });
+}
+
+#ifdef __F16C__
+// Hardware conversions, 8 lanes at a time, rounding to nearest even.
+void f16ToF32F16c(const void *x, void *y, size_t n) {
+    auto in = static_cast<const uint16_t *>(x);
+    auto out = static_cast<float *>(y);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8)
+        _mm256_storeu_ps(out + i, _mm256_cvtph_ps(_mm_loadu_si128(
+                                      (const __m128i *)(in + i))));
+    if (i < n)
+        f16ToF32(in + i, out + i, n - i);
+}
+
+void f32ToF16F16c(const void *x, void *y, size_t n) {
+    auto in = static_cast<const float *>(x);
+    auto out = static_cast<uint16_t *>(y);
+    size_t i = 0;
+    for (; i + 8 <= n; i += 8)
+        _mm_storeu_si128((__m128i *)(out + i),
+                         _mm256_cvtps_ph(_mm256_loadu_ps(in + i),
+                                         _MM_FROUND_TO_NEAREST_INT));
+    if (i < n)
+        f32ToF16(in + i, out + i, n - i);
+}
+#endif
+
+// Plain numeric types taking part in casts, as (DataType index, type).
+template <int index, typename T> struct NumericType {
+    static constexpr int i = index;
+    using t = T;
+};
+using CastTypes =
+    std::tuple<NumericType<1, float>, NumericType<2, uint8_t>,
+               NumericType<3, int8_t>, NumericType<5, int16_t>,
+               NumericType<6, int32_t>, NumericType<7, int64_t>,
+               NumericType<12, uint32_t>>;
+
+template <typename From, size_t... To>
+void setNumericCasts(VectorKernels &kernels, std::index_sequence<To...>) {
+    ((kernels.cast[From::i][std::tuple_element_t<To, CastTypes>::i] =
+          castNumeric<typename From::t,
+                      typename std::tuple_element_t<To, CastTypes>::t>),
+     ...);
+}
+
+template <size_t... From>
+void setNumericCasts(VectorKernels &kernels, std::index_sequence<From...>) {
+    constexpr auto all = std::make_index_sequence<std::tuple_size_v<CastTypes>>();
+    (setNumericCasts<std::tuple_element_t<From, CastTypes>>(kernels, all), ...);
+}
+
+void initVectorKernels(VectorKernels &kernels, CpuIsa isa) {
+    kernels.isa = isa;
+    kernels.binaryF32[(int)VecBinary::Add] = binaryRun<float, VecBinary::Add>;
+    kernels.binaryF32[(int)VecBinary::Sub] = binaryRun<float, VecBinary::Sub>;
+    kernels.binaryF32[(int)VecBinary::Mul] = binaryRun<float, VecBinary::Mul>;
+    kernels.binaryF32[(int)VecBinary::Div] = binaryRun<float, VecBinary::Div>;
+    kernels.binaryU32[(int)VecBinary::Add] =
+        binaryRun<uint32_t, VecBinary::Add>;
+    kernels.binaryU32[(int)VecBinary::Sub] =
+        binaryRun<uint32_t, VecBinary::Sub>;
+    kernels.binaryU32[(int)VecBinary::Mul] =
+        binaryRun<uint32_t, VecBinary::Mul>;
+    // no SIMD integer division on x86; keep the scalar kernel
+    kernels.binaryU32[(int)VecBinary::Div] = nullptr;
+    kernels.reluF32 = reluRun<float>;
+    kernels.clipF32 = clipRun<float>;
+    kernels.clipU32 = clipRun<uint32_t>;
+    setNumericCasts(kernels,
+                    std::make_index_sequence<std::tuple_size_v<CastTypes>>());
+    // DataType::Float16 is 10 and DataType::BFloat16 is 16
+    kernels.cast[16][1] = bf16ToF32;
+    kernels.cast[1][16] = f32ToBf16;
+#ifdef __F16C__
+    kernels.cast[10][1] = f16ToF32F16c;
+    kernels.cast[1][10] = f32ToF16F16c;
+#else
+    kernels.cast[10][1] = f16ToF32;
+    kernels.cast[1][10] = f32ToF16;
+#endif
+}
+
+} // namespace
+} // namespace infini
@@ -0,0 +1,9 @@
+// Compiled with -msse4.1, see CMakeLists.txt.
+#define VECTOR_BYTES 16
+#include "vectorized_impl.h"
+
+namespace infini {
+void initVectorKernelsSse41(VectorKernels &kernels) {
+    initVectorKernels(kernels, CpuIsa::SSE41);
+}
+} // namespace infini
@@ -16,7 +16,12 @@ optional<vector<Shape>> ConcatObj::inferShape(const TensorVec &inputs) {
     // =================================== 作业 ===================================
     // TODO：修改 dims，返回正确的 concat 后的 shape
     // REF: https://onnx.ai/onnx/operators/onnx__Concat.html#concat-13
+    // a sum of symbolic dimensions is not a dimension of its own
+    IT_ASSERT(!isSymbolic(dims[dim]),
+              "Concat: The concat dimension must not be symbolic.");
     for (size_t i = 1; i < inputs.size(); ++i) {
+        IT_ASSERT(!isSymbolic(inputs[i]->getDims()[dim]),
+                  "Concat: The concat dimension must not be symbolic.");
         IT_ASSERT(inputs[i]->getRank() == rank,
                   "Concat: All input tensors must have the same rank.");
         for (size_t j = 0; j < static_cast<size_t>(rank); ++j) {
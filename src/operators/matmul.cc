@@ -67,7 +67,8 @@ namespace infini
             int dimB = B->getDims()[i];
             IT_ASSERT(dimA == dimB || dimA == 1 || dimB == 1,
                       "Matmul: Batch dimensions must be broadcastable.");
-            ans[i] = std::max(dimA, dimB);
+            // 符号维度为负数，不能用 max 选出非 1 的一方
+            ans[i] = dimA == 1 ? dimB : dimA;
         }
         
         ans[rankA - 2] = m;
@@ -0,0 +1,91 @@
+#include "operators/quantize.h"
+#include <cmath>
+
+namespace infini
+{
+
+    QuantParams QuantParams::fromRange(float min, float max)
+    {
+        min = std::min(min, 0.f);
+        max = std::max(max, 0.f);
+        float scale = (max - min) / 255.f;
+        if (!(scale > 0.f))
+            return QuantParams(1.f, 0);
+        int zeroPoint = int(std::nearbyint(-128.f - min / scale));
+        return QuantParams(scale, std::min(127, std::max(-128, zeroPoint)));
+    }
+
+    string QuantParams::toString() const
+    {
+        std::ostringstream os;
+        os << "scale=" << vecToString(scale) << ",zp=" << vecToString(zeroPoint);
+        return os.str();
+    }
+
+    QuantizeLinearObj::QuantizeLinearObj(GraphObj *graph, Tensor input,
+                                         Tensor output, QuantParams params)
+        : OperatorObj(OpType::QuantizeLinear, {input}, {output}),
+          params(std::move(params))
+    {
+        IT_ASSERT(checkValid(graph));
+    }
+
+    optional<vector<Shape>> QuantizeLinearObj::inferShape(const TensorVec &inputs)
+    {
+        IT_ASSERT(inputs[0]->getDType() == DataType::Float32,
+                  "QuantizeLinear: input must be Float32.");
+        IT_ASSERT(params.size() == 1 && params.zeroPoint.size() == 1,
+                  "QuantizeLinear: only per-tensor quantization is supported.");
+        return {{inputs[0]->getDims()}};
+    }
+
+    vector<DataType> QuantizeLinearObj::inferDataType(const TensorVec &inputs) const
+    {
+        return {DataType::Int8};
+    }
+
+    std::string QuantizeLinearObj::toString() const
+    {
+        std::ostringstream os;
+        os << type.toString() << "[" << getGuid() << "]";
+        os << "(";
+        os << "input=" << inputs[0]->getGuid() << ",";
+        os << "output=" << outputs[0]->getGuid() << ",";
+        os << params.toString() << ")";
+        return os.str();
+    }
+
+    DequantizeLinearObj::DequantizeLinearObj(GraphObj *graph, Tensor input,
+                                             Tensor output, QuantParams params)
+        : OperatorObj(OpType::DequantizeLinear, {input}, {output}),
+          params(std::move(params))
+    {
+        IT_ASSERT(checkValid(graph));
+    }
+
+    optional<vector<Shape>> DequantizeLinearObj::inferShape(const TensorVec &inputs)
+    {
+        IT_ASSERT(inputs[0]->getDType() == DataType::Int8,
+                  "DequantizeLinear: input must be Int8.");
+        IT_ASSERT(params.size() == 1 && params.zeroPoint.size() == 1,
+                  "DequantizeLinear: only per-tensor quantization is supported.");
+        return {{inputs[0]->getDims()}};
+    }
+
+    vector<DataType> DequantizeLinearObj::inferDataType(const TensorVec &inputs) const
+    {
+        return {DataType::Float32};
+    }
+
+    std::string DequantizeLinearObj::toString() const
+    {
+        std::ostringstream os;
+        os << type.toString() << "[" << getGuid() << "]";
+        os << "(";
+        os << "input=" << inputs[0]->getGuid() << ",";
+        os << "output=" << outputs[0]->getGuid() << ",";
+        os << params.toString() << ")";
+        return os.str();
+    }
+
+} // namespace infini
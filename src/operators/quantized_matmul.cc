@@ -0,0 +1,69 @@
+#include "operators/quantized_matmul.h"
+
+namespace infini
+{
+
+    QuantizedMatmulObj::QuantizedMatmulObj(GraphObj *graph, Tensor A, Tensor B,
+                                           Tensor C, QuantParams aParams,
+                                           QuantParams bParams,
+                                           optional<QuantParams> cParams,
+                                           bool transB)
+        : OperatorObj(OpType::QuantizedMatMul, TensorVec{A, B}, {C}),
+          transB(transB), aParams(std::move(aParams)),
+          bParams(std::move(bParams)), cParams(std::move(cParams))
+    {
+        IT_ASSERT(checkValid(graph));
+    }
+
+    string QuantizedMatmulObj::toString() const
+    {
+        std::ostringstream os;
+        os << "QuantizedMatmul([A," << (transB ? "B^T" : "B") << "]"
+           << ",A=" << inputs[0]->getGuid() << "(" << aParams.toString() << ")"
+           << ",B=" << inputs[1]->getGuid() << "(" << bParams.toString() << ")"
+           << ",C=" << outputs[0]->getGuid();
+        if (cParams)
+            os << "(" << cParams->toString() << ")";
+        os << ",mnk=[" << m << "," << n << "," << k << "])";
+        return os.str();
+    }
+
+    optional<vector<Shape>> QuantizedMatmulObj::inferShape(const TensorVec &inputs)
+    {
+        auto A = inputs[0], B = inputs[1];
+        IT_ASSERT(A->getDType() == DataType::Int8 ||
+                      A->getDType() == DataType::UInt8,
+                  "QuantizedMatmul: A must be Int8 or UInt8.");
+        IT_ASSERT(B->getDType() == DataType::Int8,
+                  "QuantizedMatmul: B must be Int8.");
+        int rankA = A->getRank();
+        IT_ASSERT(rankA >= 2 && B->getRank() == 2,
+                  "QuantizedMatmul: B must be a matrix.");
+        auto aDims = A->getDims(), bDims = B->getDims();
+        m = aDims[rankA - 2];
+        k = aDims[rankA - 1];
+        IT_ASSERT(k == (transB ? bDims[1] : bDims[0]),
+                  "QuantizedMatmul: Input tensors must have compatible shapes.");
+        n = transB ? bDims[0] : bDims[1];
+
+        IT_ASSERT(aParams.size() == 1 && aParams.zeroPoint.size() == 1,
+                  "QuantizedMatmul: A must be quantized per tensor.");
+        IT_ASSERT((bParams.size() == 1 || bParams.size() == (size_t)n) &&
+                      bParams.zeroPoint.size() == bParams.size(),
+                  "QuantizedMatmul: B must be quantized per tensor or per "
+                  "output channel.");
+        IT_ASSERT(!cParams ||
+                      (cParams->size() == 1 && cParams->zeroPoint.size() == 1),
+                  "QuantizedMatmul: C must be quantized per tensor.");
+
+        Shape ans = aDims;
+        ans[rankA - 1] = n;
+        return {{ans}};
+    }
+
+    vector<DataType> QuantizedMatmulObj::inferDataType(const TensorVec &inputs) const
+    {
+        return {cParams ? DataType::Int8 : DataType::Float32};
+    }
+
+} // namespace infini
@@ -0,0 +1,82 @@
+#include "utils/cpu_features.h"
+#include <cstdlib>
+#include <fstream>
+#include <initializer_list>
+#include <strings.h>
+
+namespace infini {
+
+static CpuIsa detectCpuIsa() {
+    CpuIsa isa = CpuIsa::Generic;
+#if defined(__x86_64__) || defined(__i386__)
+    __builtin_cpu_init();
+    bool avx2 = __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma") &&
+                __builtin_cpu_supports("f16c");
+    if (avx2 && __builtin_cpu_supports("avx512f"))
+        isa = CpuIsa::AVX512;
+    else if (avx2)
+        isa = CpuIsa::AVX2;
+    else if (__builtin_cpu_supports("sse4.1"))
+        isa = CpuIsa::SSE41;
+#endif
+    if (const char *cap = std::getenv("INFINI_CPU_ISA")) {
+        for (auto level : {CpuIsa::Generic, CpuIsa::SSE41, CpuIsa::AVX2,
+                           CpuIsa::AVX512}) {
+            if (strcasecmp(cap, cpuIsaToString(level)) == 0 && level < isa) {
+                isa = level;
+                break;
+            }
+        }
+    }
+    return isa;
+}
+
+CpuIsa getCpuIsa() {
+    static const CpuIsa isa = detectCpuIsa();
+    return isa;
+}
+
+bool cpuHasVnni() {
+    static const bool vnni = [] {
+#if defined(__x86_64__) || defined(__i386__)
+        return getCpuIsa() >= CpuIsa::AVX512 &&
+               __builtin_cpu_supports("avx512vnni") &&
+               __builtin_cpu_supports("avx512vl");
+#else
+        return false;
+#endif
+    }();
+    return vnni;
+}
+
+const std::string &getCpuModel() {
+    static const std::string model = [] {
+        std::ifstream cpuinfo("/proc/cpuinfo");
+        std::string line;
+        while (std::getline(cpuinfo, line)) {
+            if (line.rfind("model name", 0) != 0)
+                continue;
+            auto colon = line.find(':');
+            auto begin = line.find_first_not_of(" \t", colon + 1);
+            if (colon != std::string::npos && begin != std::string::npos)
+                return line.substr(begin);
+        }
+        return std::string("unknown");
+    }();
+    return model;
+}
+
+const char *cpuIsaToString(CpuIsa isa) {
+    switch (isa) {
+    case CpuIsa::SSE41:
+        return "sse41";
+    case CpuIsa::AVX2:
+        return "avx2";
+    case CpuIsa::AVX512:
+        return "avx512";
+    default:
+        return "generic";
+    }
+}
+
+} // namespace infini
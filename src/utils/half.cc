@@ -0,0 +1,28 @@
+#include "utils/half.h"
+#include "utils/vectorized.h"
+
+namespace infini {
+
+void halfToFloat(DataType type, const uint16_t *x, float *y, size_t n) {
+    IT_ASSERT(type == DataType::Float16 || type == DataType::BFloat16);
+    if (auto run = getVectorKernels().cast[type.getIndex()][1]) {
+        run(x, y, n);
+        return;
+    }
+    const bool bf16 = type == DataType::BFloat16;
+    for (size_t i = 0; i < n; ++i)
+        y[i] = bf16 ? bf16ToFloat(x[i]) : fp16ToFloat(x[i]);
+}
+
+void floatToHalf(DataType type, const float *x, uint16_t *y, size_t n) {
+    IT_ASSERT(type == DataType::Float16 || type == DataType::BFloat16);
+    if (auto run = getVectorKernels().cast[1][type.getIndex()]) {
+        run(x, y, n);
+        return;
+    }
+    const bool bf16 = type == DataType::BFloat16;
+    for (size_t i = 0; i < n; ++i)
+        y[i] = bf16 ? floatToBf16(x[i]) : floatToFp16(x[i]);
+}
+
+} // namespace infini
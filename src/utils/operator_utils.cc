@@ -35,7 +35,9 @@ Shape infer_broadcast(const Shape &A, const Shape &B) {
         
         IT_ASSERT(dimA == dimB || dimA == 1 || dimB == 1,
                   "Broadcast: Incompatible shapes for broadcast.");
-        ans[maxRank - 1 - i] = std::max(dimA, dimB);
+        // symbolic dimensions are negative, so take the one that is not 1
+        // rather than the larger
+        ans[maxRank - 1 - i] = dimA == 1 ? dimB : dimA;
     }
 
     // =================================== 作业 ===================================
@@ -94,9 +96,11 @@ std::string device_to_str(Device device) {
 }
 
 std::string get_kernel_attrs_str(const KernelAttrs &kernelAttrs) {
-    std::string deviceStr = device_to_str(std::get<0>(kernelAttrs));
-    std::string opStr = OpType(std::get<1>(kernelAttrs)).toString();
-    return deviceStr + ", " + opStr;
+    std::string deviceStr = device_to_str(kernelAttrs.device);
+    std::string opStr = OpType(kernelAttrs.opType).toString();
+    if (kernelAttrs.dtype == DataType::Undefine)
+        return deviceStr + ", " + opStr;
+    return deviceStr + ", " + opStr + ", " + kernelAttrs.dtype.toString();
 }
 
 } // namespace infini
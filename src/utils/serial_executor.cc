@@ -0,0 +1,42 @@
+#include "utils/serial_executor.h"
+
+namespace infini {
+
+SerialExecutor::SerialExecutor() : thread([this] { loop(); }) {}
+
+SerialExecutor::~SerialExecutor() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    taskQueued.notify_one();
+    thread.join();
+}
+
+std::future<void> SerialExecutor::post(std::function<void()> task) {
+    std::packaged_task<void()> packaged(std::move(task));
+    auto future = packaged.get_future();
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        tasks.emplace_back(std::move(packaged));
+    }
+    taskQueued.notify_one();
+    return future;
+}
+
+void SerialExecutor::loop() {
+    while (true) {
+        std::packaged_task<void()> task;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            taskQueued.wait(lock, [&] { return stopping || !tasks.empty(); });
+            if (tasks.empty())
+                return;
+            task = std::move(tasks.front());
+            tasks.pop_front();
+        }
+        task();
+    }
+}
+
+} // namespace infini
@@ -0,0 +1,149 @@
+#include "utils/thread_pool.h"
+#ifdef __linux__
+#include <pthread.h>
+#include <sched.h>
+#endif
+
+namespace infini {
+
+namespace {
+// the pool and queue index of the current thread, if it is a worker
+thread_local const ThreadPool *currentPool = nullptr;
+thread_local int currentQueue = -1;
+} // namespace
+
+ThreadPool::ThreadPool(size_t nThreads, const std::vector<int> &cores) {
+    // a pool without workers still needs a queue for submitted tasks
+    for (size_t i = 0; i < std::max<size_t>(1, nThreads); ++i)
+        queues.emplace_back(std::make_unique<Queue>());
+    for (size_t i = 0; i < nThreads; ++i) {
+        workers.emplace_back([this, i] { workerLoop(i); });
+#ifdef __linux__
+        if (!cores.empty()) {
+            cpu_set_t set;
+            CPU_ZERO(&set);
+            CPU_SET(cores[i % cores.size()], &set);
+            pthread_setaffinity_np(workers.back().native_handle(), sizeof(set),
+                                   &set);
+        }
+#endif
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    taskQueued.notify_all();
+    for (auto &worker : workers)
+        worker.join();
+}
+
+int ThreadPool::ownQueue() const {
+    return currentPool == this ? currentQueue : -1;
+}
+
+void ThreadPool::submit(Task task) {
+    int self = ownQueue();
+    size_t target =
+        self >= 0 ? self : nextQueue.fetch_add(1) % queues.size();
+    {
+        std::lock_guard<std::mutex> lock(queues[target]->mutex);
+        queues[target]->tasks.emplace_back(std::move(task));
+    }
+    {
+        // under the lock, so that a worker about to sleep sees the task
+        std::lock_guard<std::mutex> lock(mutex);
+        ++pending;
+    }
+    taskQueued.notify_one();
+}
+
+bool ThreadPool::tryRunOne(int self) {
+    Task task;
+    const size_t n = queues.size();
+    // own deque from the back, then the others from the front
+    if (self >= 0) {
+        auto &queue = *queues[self];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (!queue.tasks.empty()) {
+            task = std::move(queue.tasks.back());
+            queue.tasks.pop_back();
+        }
+    }
+    for (size_t k = 1; !task && k <= n; ++k) {
+        auto &queue = *queues[(std::max(self, 0) + k) % n];
+        std::lock_guard<std::mutex> lock(queue.mutex);
+        if (!queue.tasks.empty()) {
+            task = std::move(queue.tasks.front());
+            queue.tasks.pop_front();
+        }
+    }
+    if (!task)
+        return false;
+    --pending;
+    task();
+    std::lock_guard<std::mutex> lock(mutex);
+    if (waiters > 0)
+        taskDone.notify_all();
+    return true;
+}
+
+void ThreadPool::waitUntil(const std::function<bool()> &done) {
+    const int self = ownQueue();
+    while (!done()) {
+        if (tryRunOne(self))
+            continue;
+        std::unique_lock<std::mutex> lock(mutex);
+        ++waiters;
+        taskDone.wait(lock, [&] { return pending > 0 || done(); });
+        --waiters;
+    }
+}
+
+void ThreadPool::parallelFor(size_t range, size_t grain,
+                             const std::function<void(size_t, size_t)> &fn) {
+    grain = std::max<size_t>(1, grain);
+    const size_t nChunks =
+        std::min((range + grain - 1) / grain, workers.size() + 1);
+    if (nChunks <= 1) {
+        if (range > 0)
+            fn(0, range);
+        return;
+    }
+
+    std::atomic<size_t> done(0);
+    std::atomic<bool> failed(false);
+    std::exception_ptr error;
+    auto runChunk = [&](size_t chunk) {
+        try {
+            fn(range * chunk / nChunks, range * (chunk + 1) / nChunks);
+        } catch (...) {
+            if (!failed.exchange(true))
+                error = std::current_exception();
+        }
+        ++done;
+    };
+    for (size_t chunk = 1; chunk < nChunks; ++chunk)
+        submit([&runChunk, chunk] { runChunk(chunk); });
+    runChunk(0);
+    waitUntil([&] { return done == nChunks; });
+    if (error)
+        std::rethrow_exception(error);
+}
+
+void ThreadPool::workerLoop(int self) {
+    currentPool = this;
+    currentQueue = self;
+    while (true) {
+        if (tryRunOne(self))
+            continue;
+        std::unique_lock<std::mutex> lock(mutex);
+        taskQueued.wait(lock, [&] { return pending > 0 || stopping; });
+        if (stopping && pending == 0)
+            return;
+    }
+}
+
+} // namespace infini
@@ -71,4 +71,61 @@ namespace infini
         EXPECT_EQ(ptr1, ptr2);
     }
 
+    TEST(Allocator, testAllocAfterFreeDoesNotOverlap)
+    {
+        Shape shape = Shape{1, 2, 2, 3};
+        Runtime runtime = NativeCpuRuntimeObj::getInstance();
+        Tensor a = make_ref<TensorObj>(shape, DataType::Float32, runtime);
+        Tensor b = make_ref<TensorObj>(shape, DataType::Float32, runtime);
+        Tensor c =
+            make_ref<TensorObj>(Shape{2, 2, 2, 3}, DataType::Float32, runtime);
+        Allocator allocator = Allocator(runtime);
+        size_t offsetA = allocator.alloc(a->getBytes());
+        size_t offsetB = allocator.alloc(b->getBytes());
+        // free a, then allocate c which does not fit into a's hole
+        allocator.free(offsetA, a->getBytes());
+        size_t offsetC = allocator.alloc(c->getBytes());
+        // expected to be placed after b instead of overlapping it
+        EXPECT_GE(offsetC, offsetB + b->getBytes());
+    }
+
+    TEST(Allocator, testAllocPolicy)
+    {
+        Runtime runtime = NativeCpuRuntimeObj::getInstance();
+        auto place = [&](AllocPolicy policy)
+        {
+            Allocator allocator = Allocator(runtime, policy);
+            // allocate a(32)->b(8)->c(16)->d(8), then free a and c, leaving
+            // holes of 32 bytes at 0 and 16 bytes at 40
+            size_t offsetA = allocator.alloc(32);
+            allocator.alloc(8);
+            size_t offsetC = allocator.alloc(16);
+            allocator.alloc(8);
+            allocator.free(offsetA, 32);
+            allocator.free(offsetC, 16);
+            size_t offset = allocator.alloc(16);
+            EXPECT_EQ(allocator.getPeak(), 64u);
+            return offset;
+        };
+        EXPECT_EQ(place(AllocPolicy::FirstFit), 0u);
+        EXPECT_EQ(place(AllocPolicy::BestFit), 40u);
+        EXPECT_EQ(place(AllocPolicy::WorstFit), 0u);
+    }
+
+    TEST(Allocator, testFreeCoalescesWithBestFit)
+    {
+        Runtime runtime = NativeCpuRuntimeObj::getInstance();
+        Allocator allocator = Allocator(runtime, AllocPolicy::BestFit);
+        size_t offsetA = allocator.alloc(16);
+        size_t offsetB = allocator.alloc(16);
+        size_t offsetC = allocator.alloc(16);
+        allocator.alloc(16);
+        // freeing a, c and then b merges them into one 48-byte block
+        allocator.free(offsetA, 16);
+        allocator.free(offsetC, 16);
+        allocator.free(offsetB, 16);
+        EXPECT_EQ(allocator.alloc(48), offsetA);
+        EXPECT_EQ(allocator.getPeak(), 64u);
+    }
+
 } // namespace infini
@@ -0,0 +1,111 @@
+#include "core/batch_scheduler.h"
+#include "core/graph.h"
+#include "core/runtime.h"
+#include "operators/element_wise.h"
+#include "operators/matmul.h"
+#include "operators/unary.h"
+
+#include "test.h"
+#include <cmath>
+#include <cstring>
+
+namespace infini
+{
+    TEST(BatchScheduler, MatchesSingleRuns)
+    {
+        // Relu(x * w + bias), for `batch` rows of x
+        auto build = [](int batch)
+        {
+            Runtime runtime = NativeCpuRuntimeObj::getInstance();
+            Graph g = make_ref<GraphObj>(runtime);
+            auto x = g->addTensor({batch, 32}, DataType::Float32);
+            auto w = g->addTensor({32, 48}, DataType::Float32);
+            auto bias = g->addTensor({48}, DataType::Float32);
+            auto mm = g->addOp<MatmulObj>(x, w, nullptr);
+            auto add = g->addOp<AddObj>(mm->getOutput(), bias, nullptr);
+            g->addOp<ReluObj>(add->getOutput(), nullptr);
+            return g;
+        };
+        Graph g = build(1);
+        g->dataMalloc();
+        auto x = g->getTensors()[0], y = g->getOutputs()[0];
+        for (auto &input : g->getInputs())
+            input->setData([](void *data, size_t size, DataType)
+                           {
+                               for (size_t i = 0; i < size; ++i)
+                                   static_cast<float *>(data)[i] =
+                                       std::sin(0.31f * i);
+                           });
+
+        constexpr int nRequests = 12;
+        vector<vector<float>> inputs, expected;
+        for (int r = 0; r < nRequests; ++r)
+        {
+            inputs.emplace_back(x->size());
+            for (size_t i = 0; i < x->size(); ++i)
+                inputs[r][i] = std::cos(0.17f * i + r);
+            std::memcpy(x->getRawDataPtr<void *>(), inputs[r].data(),
+                        x->getBytes());
+            g->getRuntime()->run(g);
+            auto out = y->getRawDataPtr<float *>();
+            expected.emplace_back(out, out + y->size());
+        }
+
+        vector<vector<float>> outputs(nRequests, vector<float>(y->size()));
+        {
+            BatchSchedulerObj scheduler(build, g, {x}, 4,
+                                        std::chrono::milliseconds(5));
+            vector<std::future<void>> futures;
+            for (int r = 0; r < nRequests; ++r)
+                futures.emplace_back(
+                    scheduler.submit({inputs[r].data()}, {outputs[r].data()}));
+            for (auto &future : futures)
+                future.get();
+
+            // a lone request is not held longer than the latency budget
+            vector<float> single(y->size());
+            scheduler.submit({inputs[0].data()}, {single.data()}).get();
+            EXPECT_EQ(single, expected[0]);
+        }
+        for (int r = 0; r < nRequests; ++r)
+            for (size_t i = 0; i < y->size(); ++i)
+                EXPECT_NEAR(outputs[r][i], expected[r][i], 1e-5);
+    }
+
+    TEST(BatchScheduler, RejectsMismatchedWeights)
+    {
+        // the batched graphs add the weights in the other order, so they no
+        // longer line up with the reference graph's, though their sizes do
+        auto build = [](int batch)
+        {
+            Runtime runtime = NativeCpuRuntimeObj::getInstance();
+            Graph g = make_ref<GraphObj>(runtime);
+            auto x = g->addTensor({batch, 4}, DataType::Float32);
+            Tensor w1, w2;
+            if (batch == 1)
+            {
+                w1 = g->addTensor({4, 8}, DataType::Float32);
+                w2 = g->addTensor({8, 4}, DataType::Float32);
+            }
+            else
+            {
+                w2 = g->addTensor({8, 4}, DataType::Float32);
+                w1 = g->addTensor({4, 8}, DataType::Float32);
+            }
+            auto mm = g->addOp<MatmulObj>(x, w1, nullptr);
+            g->addOp<MatmulObj>(mm->getOutput(), w2, nullptr);
+            return g;
+        };
+        Graph g = build(1);
+        g->dataMalloc();
+        auto x = g->getTensors()[0];
+
+        vector<float> input(4, 1.f), output0(4), output1(4);
+        BatchSchedulerObj scheduler(build, g, {x}, 2, std::chrono::seconds(10));
+        auto first = scheduler.submit({input.data()}, {output0.data()});
+        auto second = scheduler.submit({input.data()}, {output1.data()});
+        EXPECT_ANY_THROW(first.get());
+        EXPECT_ANY_THROW(second.get());
+    }
+
+} // namespace infini
@@ -0,0 +1,125 @@
+#include "core/compiled_model.h"
+#include "core/graph.h"
+#include "core/runtime.h"
+#include "operators/concat.h"
+#include "operators/element_wise.h"
+#include "operators/matmul.h"
+#include "operators/unary.h"
+
+#include "test.h"
+#include <cmath>
+#include <cstring>
+#include <thread>
+
+namespace infini
+{
+    TEST(CompiledModel, ConcurrentContexts)
+    {
+        // two towers joined by a Concat, so the plan has reused and aliased
+        // buffers
+        Runtime runtime = NativeCpuRuntimeObj::getInstance();
+        Graph g = make_ref<GraphObj>(runtime);
+        auto x = g->addTensor({1, 8, 32}, DataType::Float32);
+        auto w = g->addTensor({1, 32, 32}, DataType::Float32);
+        auto mm = g->addOp<MatmulObj>(x, w, nullptr);
+        auto relu = g->addOp<ReluObj>(mm->getOutput(), nullptr);
+        auto mm2 = g->addOp<MatmulObj>(relu->getOutput(), w, nullptr);
+        auto clip = g->addOp<ClipObj>(mm->getOutput(), nullptr, -1.f, 1.f);
+        auto y = g->addOp<ConcatObj>(
+                      TensorVec{mm2->getOutput(), clip->getOutput()}, nullptr, 2)
+                     ->getOutput();
+        g->dataMalloc();
+        w->setData([](void *data, size_t size, DataType)
+                   {
+                       for (size_t i = 0; i < size; ++i)
+                           static_cast<float *>(data)[i] = std::sin(0.7f * i) / 4;
+                   });
+
+        constexpr int nThreads = 4, nRuns = 20;
+        vector<vector<float>> inputs, expected;
+        for (int t = 0; t < nThreads; ++t)
+        {
+            inputs.emplace_back(x->size());
+            for (size_t i = 0; i < x->size(); ++i)
+                inputs[t][i] = std::cos(0.05f * i + t);
+            std::memcpy(x->getRawDataPtr<void *>(), inputs[t].data(),
+                        x->getBytes());
+            runtime->run(g);
+            auto out = y->getRawDataPtr<float *>();
+            expected.emplace_back(out, out + y->size());
+        }
+
+        auto model = make_ref<CompiledModelObj>(g, TensorVec{x});
+        vector<ExecutionContext> contexts;
+        for (int t = 0; t < nThreads; ++t)
+            contexts.emplace_back(make_ref<ExecutionContextObj>(model));
+        // weights are shared, activations are not
+        EXPECT_EQ(contexts[0]->getData(w), w->getRawDataPtr<void *>());
+        EXPECT_NE(contexts[0]->getData(y), contexts[1]->getData(y));
+        EXPECT_NE(contexts[0]->getData(y), y->getRawDataPtr<void *>());
+
+        vector<std::thread> threads;
+        vector<int> mismatches(nThreads, 0);
+        for (int t = 0; t < nThreads; ++t)
+            threads.emplace_back([&, t]
+                                 {
+                                     auto &context = contexts[t];
+                                     for (int r = 0; r < nRuns; ++r)
+                                     {
+                                         std::memcpy(context->getData(x),
+                                                     inputs[t].data(), x->getBytes());
+                                         context->run();
+                                         auto out = static_cast<const float *>(
+                                             context->getData(y));
+                                         if (!std::equal(out, out + y->size(),
+                                                         expected[t].begin()))
+                                             ++mismatches[t];
+                                     } });
+        for (auto &thread : threads)
+            thread.join();
+        for (int t = 0; t < nThreads; ++t)
+            EXPECT_EQ(mismatches[t], 0);
+    }
+
+    TEST(CompiledModel, ArenaHoldsActivationsOnly)
+    {
+        Runtime runtime = NativeCpuRuntimeObj::getInstance();
+        Graph g = make_ref<GraphObj>(runtime);
+        auto x = g->addTensor({64, 256}, DataType::Float32);
+        auto w1 = g->addTensor({256, 256}, DataType::Float32);
+        auto w2 = g->addTensor({256, 256}, DataType::Float32);
+        auto mm = g->addOp<MatmulObj>(x, w1, nullptr);
+        auto relu = g->addOp<ReluObj>(mm->getOutput(), nullptr);
+        auto y = g->addOp<MatmulObj>(relu->getOutput(), w2, nullptr)->getOutput();
+        g->dataMalloc();
+        for (auto &input : g->getInputs())
+            input->setData([](void *data, size_t size, DataType)
+                           {
+                               for (size_t i = 0; i < size; ++i)
+                                   static_cast<float *>(data)[i] =
+                                       std::sin(0.3f * i) / 16;
+                           });
+        runtime->run(g);
+        auto out = y->getRawDataPtr<float *>();
+        vector<float> expected(out, out + y->size());
+
+        // the pool holds the weights, the contexts only x and what is
+        // computed from it
+        auto model = make_ref<CompiledModelObj>(g, TensorVec{x});
+        size_t activations = 0;
+        for (auto &tensor : g->getTensors())
+            if (tensor != w1 && tensor != w2)
+                activations += tensor->getBytes();
+        EXPECT_LE(model->getArenaSize(), activations);
+        EXPECT_LE(model->getArenaSize() + w1->getBytes() + w2->getBytes(),
+                  g->getPeakMemory());
+
+        auto context = make_ref<ExecutionContextObj>(model);
+        std::memcpy(context->getData(x), x->getRawDataPtr<void *>(),
+                    x->getBytes());
+        context->run();
+        auto data = static_cast<const float *>(context->getData(y));
+        EXPECT_TRUE(std::equal(data, data + y->size(), expected.begin()));
+    }
+
+} // namespace infini
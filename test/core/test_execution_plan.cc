@@ -0,0 +1,209 @@
+#include "core/execution_plan.h"
+#include "core/graph.h"
+#include "core/runtime.h"
+#include "operators/concat.h"
+#include "operators/element_wise.h"
+#include "operators/matmul.h"
+#include "operators/transpose.h"
+#include "operators/unary.h"
+
+#include "test.h"
+#include <cmath>
+#include <cstring>
+
+namespace infini
+{
+    namespace
+    {
+        // MatMul with a broadcast weight, bias, two unary branches joined by
+        // Concat, then Transpose.
+        Graph buildGraph(Tensor &x, Tensor &y)
+        {
+            Runtime runtime = NativeCpuRuntimeObj::getInstance();
+            Graph g = make_ref<GraphObj>(runtime);
+            x = g->addTensor({2, 16, 24}, DataType::Float32);
+            auto w = g->addTensor({1, 24, 32}, DataType::Float32);
+            auto bias = g->addTensor({32}, DataType::Float32);
+            auto mm = g->addOp<MatmulObj>(x, w, nullptr);
+            auto add = g->addOp<AddObj>(mm->getOutput(), bias, nullptr);
+            auto relu = g->addOp<ReluObj>(add->getOutput(), nullptr);
+            auto clip = g->addOp<ClipObj>(add->getOutput(), nullptr, -1.f, 1.f);
+            auto concat = g->addOp<ConcatObj>(
+                TensorVec{relu->getOutput(), clip->getOutput()}, nullptr, 2);
+            auto transpose = g->addOp<TransposeObj>(concat->getOutput(), nullptr,
+                                                    Shape{0, 2, 1});
+            y = transpose->getOutput();
+            g->dataMalloc();
+            for (auto &input : g->getInputs())
+                input->setData([](void *data, size_t size, DataType)
+                               {
+                                   for (size_t i = 0; i < size; ++i)
+                                       static_cast<float *>(data)[i] =
+                                           std::sin(0.37f * i);
+                               });
+            return g;
+        }
+
+        vector<float> dataOf(const Tensor &tensor)
+        {
+            auto data = tensor->getRawDataPtr<float *>();
+            return vector<float>(data, data + tensor->size());
+        }
+    } // namespace
+
+    TEST(ExecutionPlan, MatchesRun)
+    {
+        Tensor x, y;
+        Graph g = buildGraph(x, y);
+        g->getRuntime()->run(g);
+        auto ref = dataOf(y);
+
+        auto plan = make_ref<ExecutionPlanObj>(g);
+        EXPECT_EQ(plan->size(), g->getOperators().size());
+        std::memset(y->getRawDataPtr<void *>(), 0, y->getBytes());
+        plan->run();
+        EXPECT_TRUE(y->equalData(ref));
+
+        // the plan keeps pointers, not data: new inputs give new outputs
+        x->setData(IncrementalGenerator());
+        g->getRuntime()->run(g);
+        auto updated = dataOf(y);
+        std::memset(y->getRawDataPtr<void *>(), 0, y->getBytes());
+        plan->run();
+        EXPECT_TRUE(y->equalData(updated));
+        EXPECT_FALSE(y->equalData(ref));
+    }
+
+    TEST(ExecutionPlan, CachedByGraph)
+    {
+        Tensor x, y;
+        Graph g = buildGraph(x, y);
+        auto runtime = g->getRuntime();
+        runtime->run(g);
+        auto ref = dataOf(y);
+
+        // run() builds the plan once and reuses it
+        const ExecutionPlanObj *plan = &g->getExecutionPlan();
+        EXPECT_EQ(plan->size(), g->getOperators().size());
+        runtime->run(g);
+        EXPECT_EQ(&g->getExecutionPlan(), plan);
+        EXPECT_TRUE(y->equalData(ref));
+
+        // a new op and a new memory pool are picked up
+        auto z = g->addOp<ReluObj>(y, nullptr)->getOutput();
+        vector<vector<char>> inputs;
+        for (auto &input : g->getInputs())
+        {
+            auto data = input->getRawDataPtr<char *>();
+            inputs.emplace_back(data, data + input->getBytes());
+        }
+        g->dataMalloc();
+        for (size_t i = 0; i < inputs.size(); ++i)
+            std::memcpy(g->getInputs()[i]->getRawDataPtr<void *>(),
+                        inputs[i].data(), inputs[i].size());
+        runtime->run(g);
+        EXPECT_EQ(g->getExecutionPlan().size(), g->getOperators().size());
+        for (auto &value : ref)
+            value = std::max(value, 0.f);
+        EXPECT_TRUE(z->equalData(ref));
+    }
+
+    TEST(ExecutionPlan, CustomBinding)
+    {
+        Tensor x, y;
+        Graph g = buildGraph(x, y);
+        g->getRuntime()->run(g);
+        auto ref = dataOf(y);
+
+        // every tensor in a buffer of its own, graph inputs copied over
+        unordered_map<TensorObj *, vector<char>> buffers;
+        for (auto &tensor : g->getTensors())
+        {
+            auto &buffer = buffers[tensor.get()];
+            buffer.resize(tensor->getBytes());
+            if (!tensor->getSource())
+                std::memcpy(buffer.data(), tensor->getRawDataPtr<void *>(),
+                            buffer.size());
+        }
+        std::memset(y->getRawDataPtr<void *>(), 0, y->getBytes());
+        auto plan = make_ref<ExecutionPlanObj>(
+            g, [&](const Tensor &tensor) -> void *
+            { return buffers.at(tensor.get()).data(); });
+        plan->run();
+
+        auto out = reinterpret_cast<const float *>(buffers.at(y.get()).data());
+        EXPECT_TRUE(y->equalData(vector<float>(y->size(), 0.f)));
+        std::memcpy(y->getRawDataPtr<void *>(), out, y->getBytes());
+        EXPECT_TRUE(y->equalData(ref));
+    }
+
+    TEST(ExecutionPlan, ParallelMatchesSequential)
+    {
+        // four independent towers joined by a Concat
+        Runtime runtime = NativeCpuRuntimeObj::getInstance();
+        Graph g = make_ref<GraphObj>(runtime);
+        auto x = g->addTensor({8, 64}, DataType::Float32);
+        TensorVec towers;
+        for (int t = 0; t < 4; ++t)
+        {
+            auto w = g->addTensor({64, 64}, DataType::Float32);
+            auto mm = g->addOp<MatmulObj>(x, w, nullptr);
+            auto relu = g->addOp<ReluObj>(mm->getOutput(), nullptr);
+            auto mm2 = g->addOp<MatmulObj>(relu->getOutput(), w, nullptr);
+            towers.emplace_back(mm2->getOutput());
+        }
+        auto y = g->addOp<ConcatObj>(towers, nullptr, 1)->getOutput();
+        g->dataMalloc();
+        for (auto &input : g->getInputs())
+            input->setData([](void *data, size_t size, DataType)
+                           {
+                               for (size_t i = 0; i < size; ++i)
+                                   static_cast<float *>(data)[i] =
+                                       std::cos(0.11f * i) / 8;
+                           });
+        runtime->run(g);
+        auto ref = dataOf(y);
+
+        // the sequential memory plan reuses buffers across towers, which the
+        // plan turns into extra dependencies
+        ThreadPool pool(3);
+        auto plan = make_ref<ExecutionPlanObj>(g);
+        for (int repeat = 0; repeat < 10; ++repeat)
+        {
+            std::memset(y->getRawDataPtr<void *>(), 0, y->getBytes());
+            plan->run(pool);
+            EXPECT_TRUE(y->equalData(ref));
+        }
+
+        // planned for concurrent towers
+        runtime->setInterOpThreads(4);
+        EXPECT_EQ(runtime->getInterOpThreads(), 4u);
+        vector<vector<char>> inputs;
+        for (auto &input : g->getInputs())
+        {
+            auto data = input->getRawDataPtr<char *>();
+            inputs.emplace_back(data, data + input->getBytes());
+        }
+        g->dataMalloc();
+        for (size_t i = 0; i < inputs.size(); ++i)
+            std::memcpy(g->getInputs()[i]->getRawDataPtr<void *>(),
+                        inputs[i].data(), inputs[i].size());
+        for (int repeat = 0; repeat < 10; ++repeat)
+        {
+            std::memset(y->getRawDataPtr<void *>(), 0, y->getBytes());
+            runtime->run(g);
+            EXPECT_TRUE(y->equalData(ref));
+        }
+        runtime->setInterOpThreads(1);
+        EXPECT_EQ(runtime->getInterOpThreads(), 1u);
+
+        // capped to a single thread, the kernels' loops run on the caller
+        runtime->setNumThreads(1);
+        EXPECT_EQ(runtime->getNumThreads(), 1u);
+        std::memset(y->getRawDataPtr<void *>(), 0, y->getBytes());
+        runtime->run(g);
+        EXPECT_TRUE(y->equalData(ref));
+        runtime->setNumThreads(0);
+    }
+
+} // namespace infini
@@ -1,8 +1,11 @@
 #include "core/graph.h"
 #include "core/kernel.h"
 #include "core/runtime.h"
+#include "operators/concat.h"
+#include "operators/element_wise.h"
 #include "operators/matmul.h"
 #include "operators/transpose.h"
+#include "operators/unary.h"
 
 #include "test.h"
 
@@ -37,4 +40,169 @@ namespace infini
         EXPECT_EQ(op->getTransA(), false);
         EXPECT_EQ(op->getTransB(), true);
     }
-}
\ No newline at end of file
+
+    TEST(Graph, DataMallocReuse)
+    {
+        Runtime runtime = NativeCpuRuntimeObj::getInstance();
+        Graph g = make_ref<GraphObj>(runtime);
+        Tensor i = g->addTensor({2, 3}, DataType::Float32);
+        auto t1 = g->addOp<ReluObj>(i, nullptr)->getOutput();
+        auto t2 = g->addOp<ReluObj>(t1, nullptr)->getOutput();
+        auto t3 = g->addOp<ReluObj>(t2, nullptr)->getOutput();
+        auto o = g->addOp<ReluObj>(t3, nullptr)->getOutput();
+        g->dataMalloc();
+        // t1 is dead once t2 is computed, so t3 takes its place; likewise o
+        // takes t2's place. The graph input stays pinned.
+        EXPECT_EQ(t1->getRawDataPtr<void *>(), t3->getRawDataPtr<void *>());
+        EXPECT_EQ(t2->getRawDataPtr<void *>(), o->getRawDataPtr<void *>());
+        EXPECT_NE(i->getRawDataPtr<void *>(), t1->getRawDataPtr<void *>());
+        EXPECT_NE(i->getRawDataPtr<void *>(), t2->getRawDataPtr<void *>());
+
+        i->setData(IncrementalGenerator());
+        runtime->run(g);
+        EXPECT_TRUE(o->equalData(vector<float>{0, 1, 2, 3, 4, 5}));
+    }
+
+    TEST(Graph, DataMallocConcatInPlace)
+    {
+        Runtime runtime = NativeCpuRuntimeObj::getInstance();
+        Graph g = make_ref<GraphObj>(runtime);
+        Tensor i1 = g->addTensor({1, 2, 3}, DataType::Float32);
+        Tensor i2 = g->addTensor({1, 1, 3}, DataType::Float32);
+        auto t1 = g->addOp<ReluObj>(i1, nullptr)->getOutput();
+        auto t2 = g->addOp<ReluObj>(i2, nullptr)->getOutput();
+        auto c1 = g->addOp<ConcatObj>(TensorVec{t1, t2}, nullptr, 1)->getOutput();
+        // nested: c1 sits inside c2, so t1 and t2 end up inside c2 as well
+        auto c2 = g->addOp<ConcatObj>(TensorVec{c1, i2}, nullptr, 1)->getOutput();
+        auto o = g->addOp<ReluObj>(c2, nullptr)->getOutput();
+        g->dataMalloc();
+        // every producer writes straight into its slice of c2, including the
+        // graph input i2, so neither Concat copies anything
+        auto base = c2->getRawDataPtr<char *>();
+        EXPECT_EQ(c1->getRawDataPtr<char *>(), base);
+        EXPECT_EQ(t1->getRawDataPtr<char *>(), base);
+        EXPECT_EQ(t2->getRawDataPtr<char *>(), base + 6 * sizeof(float));
+        EXPECT_EQ(i2->getRawDataPtr<char *>(), base + 9 * sizeof(float));
+
+        i1->setData(IncrementalGenerator());
+        i2->setData(OneGenerator());
+        runtime->run(g);
+        EXPECT_TRUE(o->equalData(vector<float>{0, 1, 2, 3, 4, 5, 1, 1, 1, 1, 1, 1}));
+    }
+
+    TEST(Graph, SymbolicShapeInference)
+    {
+        Runtime runtime = NativeCpuRuntimeObj::getInstance();
+        Graph g = make_ref<GraphObj>(runtime);
+        const ShapeElem n = symbolicDim("N");
+        EXPECT_TRUE(isSymbolic(n));
+        EXPECT_EQ(symbolicDim("N"), n);
+        EXPECT_NE(symbolicDim("L"), n);
+        EXPECT_EQ(getSymbolName(n), "N");
+
+        auto x = g->addTensor({n, 16}, DataType::Float32);
+        auto w = g->addTensor({16, 24}, DataType::Float32);
+        auto bias = g->addTensor({1, 24}, DataType::Float32);
+        auto mm = g->addOp<MatmulObj>(x, w, nullptr)->getOutput();
+        auto add = g->addOp<AddObj>(mm, bias, nullptr)->getOutput();
+        auto relu = g->addOp<ReluObj>(add, nullptr)->getOutput();
+        auto clip = g->addOp<ClipObj>(mm, nullptr, -1.f, 1.f)->getOutput();
+        auto concat =
+            g->addOp<ConcatObj>(TensorVec{relu, clip}, nullptr, 1)->getOutput();
+        auto y = g->addOp<TransposeObj>(concat, nullptr, Shape{1, 0})->getOutput();
+        EXPECT_EQ(mm->getDims(), (Shape{n, 24}));
+        EXPECT_EQ(add->getDims(), (Shape{n, 24}));
+        EXPECT_EQ(concat->getDims(), (Shape{n, 48}));
+        EXPECT_EQ(y->getDims(), (Shape{48, n}));
+        // sums of symbols and broadcasts against other sizes cannot be told
+        EXPECT_THROW(g->addOp<ConcatObj>(TensorVec{relu, clip}, nullptr, 0),
+                     Exception);
+        auto other = g->addTensor({3, 24}, DataType::Float32);
+        EXPECT_THROW(g->addOp<AddObj>(mm, other, nullptr), Exception);
+
+        // the parametric plan fits every tensor for any n; that tensors live
+        // at the same time do not overlap is checked by the planner's tests
+        EXPECT_THROW(g->planMemory(), Exception);
+        auto plan = g->planParametricMemory(n);
+        const auto &tensors = g->getTensors();
+        for (int value : {1, 5, 32})
+        {
+            auto concrete = plan.instantiate(value);
+            for (size_t i = 0; i < tensors.size(); ++i)
+            {
+                auto dims = substitute(tensors[i]->getDims(), n, value);
+                size_t bytes = tensors[i]->getDType().getSize();
+                for (auto dim : dims)
+                    bytes *= dim;
+                EXPECT_LE(concrete.offsets[i] + bytes, concrete.peak);
+            }
+            EXPECT_GE(concrete.peak, (size_t)value * 48 * sizeof(float));
+        }
+    }
+
+    TEST(Graph, LargeGraph)
+    {
+        // 30000 units of Transpose -> Transpose -> Relu in a chain, the ops
+        // added back to front
+        const size_t units = 30000;
+        Runtime runtime = NativeCpuRuntimeObj::getInstance();
+        Graph g = make_ref<GraphObj>(runtime);
+        TensorVec chain{g->addTensor({2, 3, 4}, DataType::Float32)};
+        for (size_t u = 0; u < units; ++u)
+        {
+            chain.emplace_back(g->addTensor({2, 4, 3}, DataType::Float32));
+            chain.emplace_back(g->addTensor({2, 3, 4}, DataType::Float32));
+            chain.emplace_back(g->addTensor({2, 3, 4}, DataType::Float32));
+        }
+        for (size_t u = units; u-- > 0;)
+        {
+            g->addOpWithOutputs<ReluObj>(chain[3 * u + 2], chain[3 * u + 3]);
+            g->addOpWithOutputs<TransposeObj>(chain[3 * u + 1], chain[3 * u + 2],
+                                              Shape{0, 2, 1});
+            g->addOpWithOutputs<TransposeObj>(chain[3 * u], chain[3 * u + 1],
+                                              Shape{0, 2, 1});
+        }
+        EXPECT_TRUE(g->topo_sort());
+        const auto &ops = g->getOperators();
+        ASSERT_EQ(ops.size(), 3 * units);
+        for (size_t i = 0; i < ops.size(); ++i)
+            ASSERT_EQ(ops[i]->getInputs(0), chain[i]);
+        EXPECT_EQ(g->getTensor(chain[7]->getFuid()), chain[7]);
+        EXPECT_TRUE(g->checkValid());
+
+        // every Transpose pair cancels out; the Relus keep their order
+        g->optimize();
+        ASSERT_EQ(g->getOperators().size(), units);
+        EXPECT_EQ(g->getTensors().size(), units + 1);
+        for (size_t u = 0; u < units; ++u)
+        {
+            auto op = g->getOperators()[u];
+            ASSERT_EQ(op->getOpType(), OpType::Relu);
+            ASSERT_EQ(op->getInputs(0), chain[3 * u]);
+            ASSERT_EQ(op->getOutput(), chain[3 * u + 3]);
+        }
+        EXPECT_EQ(g->getTensor(chain[7]->getFuid()), nullptr);
+        EXPECT_TRUE(g->checkValid());
+
+        // removal keeps the order of the rest
+        g->removeOperator(g->getOperators()[1]);
+        g->removeOperator(g->getOperators()[0]);
+        EXPECT_EQ(g->getOperators().size(), units - 2);
+        EXPECT_EQ(g->getOperators()[0]->getInputs(0), chain[6]);
+        g->removeTensor(chain[0]);
+        EXPECT_EQ(g->getTensors()[0], chain[3]);
+    }
+
+    TEST(Graph, TopoSortCycle)
+    {
+        Runtime runtime = NativeCpuRuntimeObj::getInstance();
+        Graph g = make_ref<GraphObj>(runtime);
+        Tensor a = g->addTensor({2, 3}, DataType::Float32);
+        Tensor b = g->addTensor({2, 3}, DataType::Float32);
+        Tensor c = g->addTensor({2, 3}, DataType::Float32);
+        g->addOpWithOutputs<ReluObj>(a, b);
+        g->addOpWithOutputs<ReluObj>(b, a);
+        g->addOpWithOutputs<ReluObj>(c, g->addTensor({2, 3}, DataType::Float32));
+        EXPECT_FALSE(g->topo_sort());
+    }
+}
@@ -0,0 +1,79 @@
+#include "core/memory_planner.h"
+#include "core/runtime.h"
+
+#include "test.h"
+
+namespace infini
+{
+    // Buffers whose lifetimes overlap must not overlap in memory.
+    void checkPlan(const vector<TensorLifetime> &lifetimes,
+                   const MemoryPlan &plan)
+    {
+        ASSERT_EQ(plan.offsets.size(), lifetimes.size());
+        EXPECT_GE(plan.peak, plan.lowerBound);
+        for (size_t i = 0; i < lifetimes.size(); ++i)
+        {
+            EXPECT_LE(plan.offsets[i] + lifetimes[i].size, plan.peak);
+            for (size_t j = i + 1; j < lifetimes.size(); ++j)
+            {
+                const auto &a = lifetimes[i], &b = lifetimes[j];
+                if (a.last < b.first || b.last < a.first)
+                    continue;
+                EXPECT_TRUE(plan.offsets[i] + a.size <= plan.offsets[j] ||
+                            plan.offsets[j] + b.size <= plan.offsets[i])
+                    << plan.strategy << ": buffers " << i << " and " << j;
+            }
+        }
+    }
+
+    TEST(MemoryPlanner, testStrategiesAreValid)
+    {
+        Runtime runtime = NativeCpuRuntimeObj::getInstance();
+        MemoryPlanner planner(runtime);
+        // a residual block: 0 -> 1 -> 2 -> 3 with 0 also feeding step 3
+        vector<TensorLifetime> lifetimes = {
+            {64, 0, 3}, {128, 0, 1}, {32, 1, 2}, {128, 2, 3}, {64, 3, 3}};
+        EXPECT_EQ(planner.lowerBound(lifetimes), 256u);
+        checkPlan(lifetimes, planner.planOnline(lifetimes, AllocPolicy::FirstFit));
+        checkPlan(lifetimes, planner.planOnline(lifetimes, AllocPolicy::BestFit));
+        checkPlan(lifetimes, planner.planOnline(lifetimes, AllocPolicy::WorstFit));
+        checkPlan(lifetimes, planner.planGreedyBySize(lifetimes));
+        checkPlan(lifetimes, planner.planGreedyByBreadth(lifetimes));
+        checkPlan(lifetimes, planner.plan(lifetimes));
+    }
+
+    TEST(MemoryPlanner, testOfflineBeatsOnline)
+    {
+        Runtime runtime = NativeCpuRuntimeObj::getInstance();
+        MemoryPlanner planner(runtime);
+        // The online allocator puts the short-lived small buffer at offset 0,
+        // so the later large buffer cannot reuse the hole it leaves behind.
+        vector<TensorLifetime> lifetimes = {{32, 0, 0}, {32, 0, 2}, {64, 1, 2}};
+        auto online = planner.planOnline(lifetimes, AllocPolicy::BestFit);
+        auto best = planner.plan(lifetimes);
+        checkPlan(lifetimes, online);
+        checkPlan(lifetimes, best);
+        EXPECT_EQ(online.peak, 128u);
+        EXPECT_EQ(best.peak, 96u);
+        EXPECT_EQ(best.peak, best.lowerBound);
+    }
+
+    TEST(MemoryPlanner, testParametricPlan)
+    {
+        Runtime runtime = NativeCpuRuntimeObj::getInstance();
+        MemoryPlanner planner(runtime);
+        // buffers 0, 1 and 3 grow with n, 2 and 4 have a fixed size
+        vector<TensorLifetime> lifetimes = {
+            {64, 0, 3}, {128, 0, 1}, {40, 1, 2}, {128, 2, 3}, {24, 3, 3}};
+        vector<bool> scaled = {true, true, false, true, false};
+        auto parametric = planner.planParametric(lifetimes, scaled);
+        for (size_t n : {1, 3, 16})
+        {
+            auto sized = lifetimes;
+            for (size_t i = 0; i < sized.size(); ++i)
+                if (scaled[i])
+                    sized[i].size *= n;
+            checkPlan(sized, parametric.instantiate(n));
+        }
+    }
+} // namespace infini
@@ -0,0 +1,93 @@
+#include "core/graph.h"
+#include "core/runtime.h"
+#include "operators/element_wise.h"
+#include "operators/matmul.h"
+#include "operators/transpose.h"
+#include "operators/unary.h"
+
+#include "test.h"
+#include <cmath>
+
+namespace infini
+{
+    // y = relu(x * w1 + b) * w2, optionally in mixed precision. Returns y and
+    // the size of the memory pool.
+    pair<vector<float>, size_t> runMlp(optional<DataType> dtype)
+    {
+        Runtime runtime = NativeCpuRuntimeObj::getInstance();
+        Graph g = make_ref<GraphObj>(runtime);
+        Tensor x = g->addTensor({256, 64}, DataType::Float32);
+        Tensor w1 = g->addTensor({64, 64}, DataType::Float32);
+        Tensor b = g->addTensor({64}, DataType::Float32);
+        Tensor w2 = g->addTensor({64, 32}, DataType::Float32);
+        auto h = g->addOp<MatmulObj>(x, w1, nullptr)->getOutput();
+        h = g->addOp<AddObj>(h, b, nullptr)->getOutput();
+        h = g->addOp<ReluObj>(h, nullptr)->getOutput();
+        auto y = g->addOp<MatmulObj>(h, w2, nullptr)->getOutput();
+
+        g->dataMalloc();
+        auto fill = [](const Tensor &tensor)
+        {
+            auto data = tensor->getRawDataPtr<float *>();
+            for (size_t i = 0; i < tensor->size(); ++i)
+                data[i] = std::sin(i * 0.37f + tensor->size()) * 0.5f;
+        };
+        for (auto &tensor : {w1, b, w2})
+            fill(tensor);
+        if (dtype)
+        {
+            g->mixedPrecision({x}, *dtype);
+            // casts of the input and of the output; the weights are
+            // converted once and their Float32 copies dropped
+            vector<OpType> types;
+            for (auto &op : g->getOperators())
+                types.emplace_back(op->getOpType());
+            EXPECT_EQ(std::count(types.begin(), types.end(), OpType::Cast), 2);
+            EXPECT_EQ(types.size(), 6u);
+            EXPECT_EQ(y->getDType(), DataType::Float32);
+            EXPECT_EQ(y->getSource()->getOpType(), OpType::Cast);
+            for (auto &op : g->getOperators())
+                EXPECT_TRUE(op->getOpType() == OpType::Cast ||
+                            op->getOutput()->getDType() == *dtype);
+            for (auto &weight : {w1, b, w2})
+                EXPECT_FALSE(g->hasTensor(weight));
+        }
+        fill(x);
+        runtime->run(g);
+        auto data = y->getRawDataPtr<float *>();
+        return {vector<float>(data, data + y->size()), g->getPeakMemory()};
+    }
+
+    TEST(MixedPrecision, Mlp)
+    {
+        auto [ref, refPeak] = runMlp(std::nullopt);
+        for (auto dtype : {DataType::Float16, DataType::BFloat16})
+        {
+            auto [out, peak] = runMlp(dtype);
+            double err = 0, norm = 0;
+            for (size_t i = 0; i < ref.size(); ++i)
+            {
+                err += (out[i] - ref[i]) * (out[i] - ref[i]);
+                norm += ref[i] * ref[i];
+            }
+            EXPECT_LT(std::sqrt(err / norm),
+                      dtype == DataType::Float16 ? 2e-3 : 2e-2);
+            EXPECT_LT(peak, refPeak);
+        }
+    }
+
+    TEST(MixedPrecision, FollowersStayInFloat)
+    {
+        Runtime runtime = NativeCpuRuntimeObj::getInstance();
+        Graph g = make_ref<GraphObj>(runtime);
+        Tensor x = g->addTensor({8, 16}, DataType::Float32);
+        auto t = g->addOp<TransposeObj>(x, nullptr, Shape{1, 0})->getOutput();
+        g->addOp<ReluObj>(t, nullptr);
+        g->dataMalloc();
+        g->mixedPrecision({x}, DataType::Float16);
+        // nothing produces half data, so no op is lowered
+        EXPECT_EQ(g->getOperators().size(), 2u);
+        for (auto &tensor : g->getTensors())
+            EXPECT_EQ(tensor->getDType(), DataType::Float32);
+    }
+} // namespace infini
@@ -0,0 +1,141 @@
+#include "core/graph.h"
+#include "core/plan_cache.h"
+#include "core/runtime.h"
+#include "operators/concat.h"
+#include "operators/element_wise.h"
+#include "operators/matmul.h"
+#include "operators/unary.h"
+
+#include "test.h"
+#include <cmath>
+#include <cstring>
+
+namespace infini
+{
+    namespace
+    {
+        void fill(void *data, size_t size, DataType)
+        {
+            for (size_t i = 0; i < size; ++i)
+                static_cast<float *>(data)[i] = std::sin(0.23f * i);
+        }
+    } // namespace
+
+    TEST(PlanCache, MatchesFreshGraphs)
+    {
+        // Concat(Relu(x * w + bias), Clip(x * w)) along the last axis, for
+        // x of `rows` rows
+        auto build = [](int rows)
+        {
+            Runtime runtime = NativeCpuRuntimeObj::getInstance();
+            Graph g = make_ref<GraphObj>(runtime);
+            auto x = g->addTensor({rows, 16}, DataType::Float32);
+            auto w = g->addTensor({16, 24}, DataType::Float32);
+            auto bias = g->addTensor({24}, DataType::Float32);
+            auto mm = g->addOp<MatmulObj>(x, w, nullptr);
+            auto add = g->addOp<AddObj>(mm->getOutput(), bias, nullptr);
+            auto relu = g->addOp<ReluObj>(add->getOutput(), nullptr);
+            auto clip = g->addOp<ClipObj>(mm->getOutput(), nullptr, -1.f, 1.f);
+            g->addOp<ConcatObj>(TensorVec{relu->getOutput(), clip->getOutput()},
+                                nullptr, 1);
+            g->dataMalloc();
+            for (auto &input : g->getInputs())
+                input->setData(fill);
+            return g;
+        };
+        Graph g = build(2);
+        auto x = g->getTensors()[0], y = g->getOutputs()[0];
+        g->getRuntime()->run(g);
+        auto out = y->getRawDataPtr<float *>();
+        vector<float> original(out, out + y->size());
+
+        PlanCacheObj cache(g, {x}, 2);
+        for (int rows : {3, 7, 3, 1, 7})
+        {
+            Graph ref = build(rows);
+            auto refX = ref->getTensors()[0], refY = ref->getOutputs()[0];
+            ref->getRuntime()->run(ref);
+
+            cache.select({{rows, 16}});
+            EXPECT_EQ(cache.getDims(y), refY->getDims());
+            std::memcpy(cache.getData(x), refX->getRawDataPtr<void *>(),
+                        refX->getBytes());
+            cache.run();
+            auto data = static_cast<const float *>(cache.getData(y));
+            EXPECT_TRUE(refY->equalData(vector<float>(data, data + refY->size())));
+        }
+        // the second 3 hit; 1 evicted 7, the least recently used
+        EXPECT_EQ(cache.getHits(), 1u);
+        EXPECT_EQ(cache.getMisses(), 4u);
+        EXPECT_EQ(cache.size(), 2u);
+        EXPECT_FALSE(cache.select({{3, 16}}));
+        EXPECT_TRUE(cache.select({{7, 16}}));
+
+        // the graph itself keeps its shapes and data
+        EXPECT_EQ(x->getDims(), (Shape{2, 16}));
+        EXPECT_EQ(y->getDims(), (Shape{2, 48}));
+        std::memset(y->getRawDataPtr<void *>(), 0, y->getBytes());
+        g->getRuntime()->run(g);
+        EXPECT_TRUE(y->equalData(original));
+
+        // and its kernels are prepared for its own shapes: new inputs give
+        // what a fresh graph computes
+        EXPECT_FALSE(cache.select({{1, 16}}));
+        Graph ref = build(2);
+        auto refX = ref->getTensors()[0], refY = ref->getOutputs()[0];
+        for (auto &input : {x, refX})
+            input->setData([](void *data, size_t size, DataType)
+                           {
+                               for (size_t i = 0; i < size; ++i)
+                                   static_cast<float *>(data)[i] =
+                                       std::cos(0.41f * i);
+                           });
+        ref->getRuntime()->run(ref);
+        g->getRuntime()->run(g);
+        auto refOut = refY->getRawDataPtr<float *>();
+        EXPECT_TRUE(y->equalData(vector<float>(refOut, refOut + refY->size())));
+        EXPECT_FALSE(y->equalData(original));
+    }
+
+    TEST(PlanCache, SymbolicBatch)
+    {
+        // Relu(x * w), for x of `rows` rows
+        auto build = [](int rows)
+        {
+            Runtime runtime = NativeCpuRuntimeObj::getInstance();
+            Graph g = make_ref<GraphObj>(runtime);
+            auto x = g->addTensor({rows, 16}, DataType::Float32);
+            auto w = g->addTensor({16, 24}, DataType::Float32);
+            auto mm = g->addOp<MatmulObj>(x, w, nullptr);
+            g->addOp<ReluObj>(mm->getOutput(), nullptr);
+            g->dataMalloc();
+            for (auto &input : g->getInputs())
+                input->setData(fill);
+            return g;
+        };
+        Graph g = build(2);
+        auto x = g->getTensors()[0], y = g->getOutputs()[0];
+        const ShapeElem n = symbolicDim("N");
+        PlanCacheObj cache(g, {x}, 4, {{n, 16}});
+        for (int rows : {3, 5, 1})
+        {
+            Graph ref = build(rows);
+            auto refX = ref->getTensors()[0], refY = ref->getOutputs()[0];
+            ref->getRuntime()->run(ref);
+
+            cache.select({{rows, 16}});
+            std::memcpy(cache.getData(x), refX->getRawDataPtr<void *>(),
+                        refX->getBytes());
+            cache.run();
+            auto data = static_cast<const float *>(cache.getData(y));
+            EXPECT_TRUE(refY->equalData(vector<float>(data, data + refY->size())));
+        }
+        // every miss instantiated the parametric plan instead of planning
+        EXPECT_EQ(cache.getMisses(), 3u);
+        EXPECT_EQ(cache.getInstantiations(), 3u);
+        // seen again, a batch size is served from the cache
+        cache.select({{3, 16}});
+        EXPECT_EQ(cache.getHits(), 1u);
+    }
+
+} // namespace infini
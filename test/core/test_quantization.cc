@@ -0,0 +1,149 @@
+#include "core/graph.h"
+#include "core/runtime.h"
+#include "operators/matmul.h"
+#include "operators/quantized_matmul.h"
+#include "operators/unary.h"
+
+#include "test.h"
+#include <cmath>
+
+namespace infini
+{
+    // Smooth pseudo-random values in [-1, 1].
+    vector<float> wave(size_t n, float phase)
+    {
+        vector<float> data(n);
+        for (size_t i = 0; i < n; ++i)
+            data[i] = std::sin(i * 0.7f + phase) * std::cos(i * 0.13f);
+        return data;
+    }
+
+    void fill(const Tensor &tensor, const vector<float> &data)
+    {
+        std::copy(data.begin(), data.end(), tensor->getRawDataPtr<float *>());
+    }
+
+    TEST(Quantization, MatmulChain)
+    {
+        Runtime runtime = NativeCpuRuntimeObj::getInstance();
+        Graph g = make_ref<GraphObj>(runtime);
+        Tensor x = g->addTensor({4, 48}, DataType::Float32);
+        Tensor w1 = g->addTensor({48, 40}, DataType::Float32);
+        Tensor w2 = g->addTensor({24, 40}, DataType::Float32);
+        auto mm1 = g->addOp<MatmulObj>(x, w1, nullptr);
+        auto y = g->addOp<MatmulObj>(mm1->getOutput(), w2, nullptr, false, true)
+                     ->getOutput();
+        g->dataMalloc();
+        fill(w1, wave(w1->size(), 1.f));
+        fill(w2, wave(w2->size(), 2.f));
+
+        vector<CalibrationSample> calibration;
+        for (int s = 0; s < 4; ++s)
+            calibration.push_back({{x, wave(x->size(), 3.f * s)}});
+        auto report = g->quantize(calibration);
+        report.info();
+
+        // Q(x) -> QuantizedMatMul (int8 out) -> QuantizedMatMul (float out):
+        // the DQ/Q pair between the MatMuls is folded away.
+        EXPECT_EQ(report.quantizedOps, 2u);
+        EXPECT_EQ(report.foldedPairs, 1u);
+        auto ops = g->getOperators();
+        ASSERT_EQ(ops.size(), 3u);
+        EXPECT_EQ(ops[0]->getOpType(), OpType::QuantizeLinear);
+        EXPECT_EQ(ops[1]->getOpType(), OpType::QuantizedMatMul);
+        EXPECT_EQ(ops[2]->getOpType(), OpType::QuantizedMatMul);
+        EXPECT_EQ(ops[1]->getOutput()->getDType(), DataType::Int8);
+        EXPECT_EQ(ops[2]->getOutput(), y);
+        EXPECT_TRUE(as<QuantizedMatmulObj>(ops[2])->getTransB());
+        EXPECT_EQ(g->getTensors().size(), 6u);
+        ASSERT_EQ(report.sqnr.size(), 1u);
+        EXPECT_GT(report.sqnr[0], 25.0);
+    }
+
+    TEST(Quantization, FloatRegion)
+    {
+        Runtime runtime = NativeCpuRuntimeObj::getInstance();
+        Graph g = make_ref<GraphObj>(runtime);
+        Tensor x = g->addTensor({1, 6, 32}, DataType::Float32);
+        Tensor w = g->addTensor({1, 32, 32}, DataType::Float32);
+        Tensor h = g->addOp<MatmulObj>(x, w, nullptr)->getOutput();
+        Tensor r = g->addOp<ReluObj>(h, nullptr)->getOutput();
+        g->addOp<MatmulObj>(r, w, nullptr);
+        g->dataMalloc();
+        fill(w, wave(w->size(), 0.5f));
+
+        auto report = g->quantize({{{x, wave(x->size(), 0.f)}},
+                                   {{x, wave(x->size(), 1.f)}}});
+        report.info();
+
+        // Relu stays in float, so both MatMuls dequantize their outputs and
+        // the shared weight is quantized once.
+        EXPECT_EQ(report.quantizedOps, 2u);
+        EXPECT_EQ(report.foldedPairs, 0u);
+        vector<OpType> types;
+        for (auto &op : g->getOperators())
+            types.emplace_back(op->getOpType());
+        EXPECT_EQ(types, (vector<OpType>{OpType::QuantizeLinear,
+                                         OpType::QuantizedMatMul, OpType::Relu,
+                                         OpType::QuantizeLinear,
+                                         OpType::QuantizedMatMul}));
+        EXPECT_EQ(g->getOperators()[1]->getInputs(1),
+                  g->getOperators()[4]->getInputs(1));
+        EXPECT_EQ(g->getOperators()[1]->getOutput(), h);
+        EXPECT_GT(report.sqnr[0], 25.0);
+    }
+
+    TEST(Quantization, CalibratesReusedBuffers)
+    {
+        Runtime runtime = NativeCpuRuntimeObj::getInstance();
+        Graph g = make_ref<GraphObj>(runtime);
+        Tensor x = g->addTensor({2, 16}, DataType::Float32);
+        Tensor w = g->addTensor({16, 16}, DataType::Float32);
+        Tensor h = g->addOp<MatmulObj>(x, w, nullptr)->getOutput();
+        Tensor y = g->addOp<MatmulObj>(h, w, nullptr)->getOutput();
+        Tensor z = g->addOp<MatmulObj>(y, w, nullptr)->getOutput();
+        Tensor r = g->addOp<ReluObj>(z, nullptr)->getOutput();
+        Tensor o = g->addOp<ReluObj>(r, nullptr)->getOutput();
+        g->dataMalloc();
+        // h and y are dead before the Relus run, which overwrite them with
+        // non-negative data
+        ASSERT_EQ(h->getRawDataPtr<void *>(), o->getRawDataPtr<void *>());
+        ASSERT_EQ(y->getRawDataPtr<void *>(), r->getRawDataPtr<void *>());
+        auto weight = wave(w->size(), 1.f);
+        fill(w, weight);
+
+        vector<CalibrationSample> calibration;
+        TensorRange hRange{0, 0}, yRange{0, 0};
+        for (int s = 0; s < 3; ++s)
+        {
+            auto input = wave(x->size(), 2.f * s);
+            calibration.push_back({{x, input}});
+            auto matmul = [&](const vector<float> &a, TensorRange &range)
+            {
+                vector<float> c(a.size(), 0.f);
+                for (int i = 0; i < 2; ++i)
+                    for (int j = 0; j < 16; ++j)
+                        for (int p = 0; p < 16; ++p)
+                            c[i * 16 + j] += a[i * 16 + p] * weight[p * 16 + j];
+                for (auto v : c)
+                    range = {std::min(range.min, v), std::max(range.max, v)};
+                return c;
+            };
+            matmul(matmul(input, hRange), yRange);
+        }
+        g->quantize(calibration);
+
+        auto second = as<QuantizedMatmulObj>(g->getOperators()[2]);
+        ASSERT_EQ(second->getOpType(), OpType::QuantizedMatMul);
+        auto near = [](const QuantParams &params, const TensorRange &range)
+        {
+            auto expected = QuantParams::fromRange(range.min, range.max);
+            return std::abs(params.getScale(0) - expected.getScale(0)) <
+                       1e-4f * expected.getScale(0) &&
+                   std::abs(params.getZeroPoint(0) - expected.getZeroPoint(0)) <= 1;
+        };
+        EXPECT_TRUE(near(second->getAParams(), hRange));
+        ASSERT_TRUE(second->getCParams());
+        EXPECT_TRUE(near(*second->getCParams(), yRange));
+    }
+} // namespace infini
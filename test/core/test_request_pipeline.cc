@@ -0,0 +1,82 @@
+#include "core/graph.h"
+#include "core/request_pipeline.h"
+#include "core/runtime.h"
+#include "operators/element_wise.h"
+#include "operators/matmul.h"
+#include "operators/unary.h"
+
+#include "test.h"
+#include <cmath>
+#include <cstring>
+
+namespace infini
+{
+    TEST(Runtime, RunAsync)
+    {
+        Runtime runtime = NativeCpuRuntimeObj::getInstance();
+        Graph g = make_ref<GraphObj>(runtime);
+        auto x = g->addTensor({4, 32}, DataType::Float32);
+        auto y = g->addOp<ClipObj>(x, nullptr, 10.f, 100.f)->getOutput();
+        g->dataMalloc();
+        x->setData(IncrementalGenerator());
+        runtime->run(g);
+        auto ref = y->getRawDataPtr<float *>();
+        vector<float> expected(ref, ref + y->size());
+
+        std::memset(y->getRawDataPtr<void *>(), 0, y->getBytes());
+        auto done = runtime->runAsync(g);
+        done.get();
+        EXPECT_TRUE(y->equalData(expected));
+
+        // errors of a queued task come back through its future
+        auto failed = runtime->post([]
+                                    { IT_TODO_HALT(); });
+        EXPECT_THROW(failed.get(), Exception);
+    }
+
+    TEST(RequestPipeline, MatchesRun)
+    {
+        Runtime runtime = NativeCpuRuntimeObj::getInstance();
+        Graph g = make_ref<GraphObj>(runtime);
+        auto x = g->addTensor({4, 32}, DataType::Float32);
+        auto w = g->addTensor({32, 48}, DataType::Float32);
+        auto bias = g->addTensor({48}, DataType::Float32);
+        auto mm = g->addOp<MatmulObj>(x, w, nullptr);
+        auto add = g->addOp<AddObj>(mm->getOutput(), bias, nullptr);
+        auto y = g->addOp<ReluObj>(add->getOutput(), nullptr)->getOutput();
+        g->dataMalloc();
+        w->setData(IncrementalGenerator());
+        bias->setData(IncrementalGenerator());
+
+        // expected outputs, one synchronous run per request
+        constexpr int nRequests = 6;
+        vector<vector<float>> inputs, expected;
+        for (int r = 0; r < nRequests; ++r)
+        {
+            inputs.emplace_back(x->size());
+            for (size_t i = 0; i < x->size(); ++i)
+                inputs[r][i] = std::cos(0.13f * i + r);
+            std::memcpy(x->getRawDataPtr<void *>(), inputs.back().data(),
+                        x->getBytes());
+            runtime->run(g);
+            auto out = y->getRawDataPtr<float *>();
+            expected.emplace_back(out, out + y->size());
+        }
+
+        RequestPipelineObj pipeline(make_ref<CompiledModelObj>(g, TensorVec{x}));
+        ASSERT_EQ(pipeline.getOutputs().size(), 1u);
+        EXPECT_EQ(pipeline.getOutputs()[0], y);
+        vector<vector<float>> outputs(nRequests, vector<float>(y->size()));
+        vector<std::future<void>> futures;
+        for (int r = 0; r < nRequests; ++r)
+            futures.emplace_back(
+                pipeline.submit({inputs[r].data()}, {outputs[r].data()}));
+        for (int r = 0; r < nRequests; ++r)
+        {
+            futures[r].get();
+            for (size_t i = 0; i < y->size(); ++i)
+                EXPECT_EQ(outputs[r][i], expected[r][i]);
+        }
+    }
+
+} // namespace infini
@@ -0,0 +1,95 @@
+#include "core/data_type.h"
+#include "utils/thread_pool.h"
+
+#include "test.h"
+
+namespace infini
+{
+    TEST(ThreadPool, RunsAllTasks)
+    {
+        ThreadPool pool(4);
+        std::atomic<int> sum(0);
+        for (int i = 1; i <= 1000; ++i)
+            pool.submit([&sum, i]
+                        { sum += i; });
+        pool.waitUntil([&]
+                       { return sum == 500500; });
+        EXPECT_EQ(sum, 500500);
+    }
+
+    TEST(ThreadPool, NestedTasks)
+    {
+        // tasks spawning tasks and waiting for them must not deadlock, even
+        // with more waiting tasks than workers
+        ThreadPool pool(2);
+        std::atomic<int> outer(0), inner(0);
+        for (int i = 0; i < 8; ++i)
+            pool.submit([&]
+                        {
+                            std::atomic<int> done(0);
+                            for (int j = 0; j < 16; ++j)
+                                pool.submit([&]
+                                            {
+                                                ++inner;
+                                                ++done;
+                                            });
+                            pool.waitUntil([&]
+                                           { return done == 16; });
+                            ++outer;
+                        });
+        pool.waitUntil([&]
+                       { return outer == 8; });
+        EXPECT_EQ(inner, 128);
+    }
+
+    TEST(ThreadPool, ParallelForCoversRange)
+    {
+        ThreadPool pool(3);
+        vector<int> hits(1000, 0);
+        std::atomic<int> calls(0);
+        pool.parallelFor(hits.size(), 100, [&](size_t begin, size_t end)
+                         {
+                             ++calls;
+                             for (size_t i = begin; i < end; ++i)
+                                 ++hits[i];
+                         });
+        for (auto h : hits)
+            EXPECT_EQ(h, 1);
+        // one chunk per thread at most
+        EXPECT_EQ(calls, 4);
+
+        // a range within one grain stays on the calling thread
+        const auto caller = std::this_thread::get_id();
+        pool.parallelFor(50, 100, [&](size_t begin, size_t end)
+                         {
+                             EXPECT_EQ(begin, 0u);
+                             EXPECT_EQ(end, 50u);
+                             EXPECT_EQ(std::this_thread::get_id(), caller);
+                         });
+    }
+
+    TEST(ThreadPool, ParallelForWithoutWorkers)
+    {
+        ThreadPool pool(0);
+        EXPECT_EQ(pool.size(), 0u);
+        size_t sum = 0;
+        pool.parallelFor(1000, 1, [&](size_t begin, size_t end)
+                         {
+                             for (size_t i = begin; i < end; ++i)
+                                 sum += i;
+                         });
+        EXPECT_EQ(sum, 499500u);
+    }
+
+    TEST(ThreadPool, ParallelForRethrows)
+    {
+        ThreadPool pool(2);
+        EXPECT_THROW(pool.parallelFor(300, 1, [](size_t begin, size_t)
+                                      {
+                                          if (begin > 0)
+                                              throw std::runtime_error("chunk");
+                                      }),
+                     std::runtime_error);
+    }
+
+} // namespace infini
@@ -0,0 +1,85 @@
+#include "core/graph.h"
+#include "core/kernel.h"
+#include "core/runtime.h"
+#include "core/tuning_cache.h"
+#include "operators/matmul.h"
+
+#include "test.h"
+#include <cstdio>
+#include <fstream>
+
+namespace infini
+{
+    TEST(Tuning, PicksCandidateAndPersists)
+    {
+        const string path = ::testing::TempDir() + "infini_tuning_cache.txt";
+        std::remove(path.c_str());
+        auto &cache = TuningCache::getInstance();
+        cache.clear();
+
+        Runtime runtime = NativeCpuRuntimeObj::getInstance();
+        Graph g = make_ref<GraphObj>(runtime);
+        Tensor a = g->addTensor({1, 96, 300}, DataType::Float32);
+        Tensor b = g->addTensor({1, 300, 80}, DataType::Float32);
+        auto op = g->addOp<MatmulObj>(a, b, nullptr);
+        g->dataMalloc();
+        a->setData(IncrementalGenerator());
+        b->setData(IncrementalGenerator());
+        runtime->run(g);
+        auto c = op->getOutput()->getRawDataPtr<float *>();
+        vector<float> ref(c, c + op->getOutput()->size());
+
+        runtime->tune(g, path);
+        ASSERT_NE(op->getKernel(), nullptr);
+        runtime->run(g);
+        EXPECT_TRUE(op->getOutput()->equalData(ref));
+
+        // the choice is written under the op's key
+        const string key =
+            TuningCache::getKey(op, runtime->getNumThreads());
+        std::ifstream file(path);
+        string line, name;
+        while (std::getline(file, line))
+            if (line.rfind(key + "\t", 0) == 0)
+                name = line.substr(key.size() + 1);
+        ASSERT_EQ(cache.get(key), name);
+        const auto &candidates = KernelRegistry::getInstance().getCandidates(
+            KernelAttrs{Device::CPU, OpType::MatMul});
+        Kernel *chosen = nullptr;
+        for (auto &[kernel, kernelName, id] : candidates)
+            if (kernelName == name)
+                chosen = kernel;
+        EXPECT_EQ(op->getKernel(), chosen);
+
+        // a new process reads the cache file instead of timing again
+        cache.clear();
+        {
+            std::ofstream out(path);
+            out << key << "\tMatmulBlockedDeep_CPU\n";
+        }
+        runtime->tune(g, path);
+        EXPECT_EQ(cache.get(key), string("MatmulBlockedDeep_CPU"));
+        EXPECT_NE(op->getKernel(),
+                  KernelRegistry::getInstance().getKernel(
+                      KernelAttrs{Device::CPU, OpType::MatMul}));
+        runtime->run(g);
+        EXPECT_TRUE(op->getOutput()->equalData(ref));
+        cache.clear();
+        std::remove(path.c_str());
+    }
+
+    TEST(Tuning, KeyDependsOnShapeAttributesAndThreads)
+    {
+        Runtime runtime = NativeCpuRuntimeObj::getInstance();
+        Graph g = make_ref<GraphObj>(runtime);
+        Tensor a = g->addTensor({4, 8}, DataType::Float32);
+        Tensor b = g->addTensor({8, 8}, DataType::Float32);
+        auto op1 = g->addOp<MatmulObj>(a, b, nullptr);
+        auto op2 = g->addOp<MatmulObj>(a, b, nullptr, false, true);
+        auto op3 = g->addOp<MatmulObj>(op1->getOutput(), b, nullptr);
+        EXPECT_NE(TuningCache::getKey(op1, 1), TuningCache::getKey(op2, 1));
+        EXPECT_EQ(TuningCache::getKey(op1, 1), TuningCache::getKey(op3, 1));
+        // a kernel tuned on one thread is not reused on sixteen
+        EXPECT_NE(TuningCache::getKey(op1, 1), TuningCache::getKey(op1, 16));
+    }
+} // namespace infini
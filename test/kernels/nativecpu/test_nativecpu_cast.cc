@@ -0,0 +1,65 @@
+#include "core/graph.h"
+#include "core/runtime.h"
+#include "operators/unary.h"
+
+#include "test.h"
+
+namespace infini {
+
+template <typename TIn, typename TOut>
+void testCast(CastType type, DataType inType, const vector<TIn> &input,
+              const vector<TOut> &ans) {
+    Runtime runtime = NativeCpuRuntimeObj::getInstance();
+    Graph g = make_ref<GraphObj>(runtime);
+    auto i = g->addTensor({(int)input.size()}, inType);
+    auto op = g->addOp<CastObj>(i, nullptr, type);
+    g->dataMalloc();
+    std::copy(input.begin(), input.end(), i->getRawDataPtr<TIn *>());
+
+    runtime->run(g);
+    EXPECT_TRUE(op->getOutput()->equalData(ans));
+}
+
+TEST(Cast, NativeCpuHalf) {
+    const float inf = INFINITY;
+    // exact values, the largest half, overflow, subnormals, ties to even,
+    // infinities and NaN
+    testCast<float, uint16_t>(
+        CastType::Float2Float16, DataType::Float32,
+        {1.f, -2.f, 65504.f, 65520.f, 1e-8f, 6e-8f, 1.f + 0x1p-11f,
+         1.f + 0x3p-11f, -inf, NAN},
+        {0x3c00, 0xc000, 0x7bff, 0x7c00, 0x0000, 0x0001, 0x3c00, 0x3c02,
+         0xfc00, 0x7e00});
+    testCast<uint16_t, float>(CastType::Float162Float, DataType::Float16,
+                              {0x3c00, 0xc000, 0x7bff, 0x0001, 0xfc00},
+                              {1.f, -2.f, 65504.f, 0x1p-24f, -inf});
+    testCast<float, uint16_t>(
+        CastType::Float2BFloat16, DataType::Float32,
+        {1.f, -2.f, 1.f + 0x1p-8f, 1.f + 0x3p-8f, 3.4e38f, inf},
+        {0x3f80, 0xc000, 0x3f80, 0x3f82, 0x7f80, 0x7f80});
+    testCast<uint16_t, float>(CastType::BFloat162Float, DataType::BFloat16,
+                              {0x3f80, 0xc000, 0xff80}, {1.f, -2.f, -inf});
+}
+
+TEST(Cast, NativeCpuNumeric) {
+    testCast<float, int32_t>(CastType::Float2Int32, DataType::Float32,
+                             {1.9f, -1.9f, 0.f, 100.5f}, {1, -1, 0, 100});
+    testCast<int64_t, int32_t>(CastType::Int642Int32, DataType::Int64,
+                               {-5, 7, 1ll << 32 | 3}, {-5, 7, 3});
+    testCast<uint8_t, float>(CastType::Uint82Float, DataType::UInt8,
+                             {0, 1, 255}, {0.f, 1.f, 255.f});
+    testCast<int8_t, int32_t>(CastType::Int82Int32, DataType::Int8,
+                              {-128, -1, 127}, {-128, -1, 127});
+    testCast<uint32_t, int64_t>(CastType::Uint322Int64, DataType::UInt32,
+                                {0, 4000000000u}, {0, 4000000000ll});
+    // longer than a vector and a parallel task, with a ragged tail
+    vector<int32_t> in(40001), out(40001);
+    for (size_t i = 0; i < in.size(); ++i)
+        in[i] = int32_t(i * 2654435761u);
+    for (size_t i = 0; i < in.size(); ++i)
+        out[i] = int16_t(in[i]);
+    testCast<int32_t, int16_t>(CastType::Int322Int16, DataType::Int32, in,
+                               vector<int16_t>(out.begin(), out.end()));
+}
+
+} // namespace infini
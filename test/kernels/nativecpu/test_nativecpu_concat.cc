@@ -25,4 +25,26 @@ TEST(Concat, NativeCpu) {
                       6, 7, 8, 1, 1, 1, 9, 10, 11, 1, 1, 1}));
 }
 
+TEST(Concat, NativeCpuLargeRuns) {
+    // The first input's runs are longer than one copy task and get split.
+    Runtime runtime = NativeCpuRuntimeObj::getInstance();
+    Graph g = make_ref<GraphObj>(runtime);
+
+    auto t1 = g->addTensor({3, 20000}, DataType::UInt32);
+    auto t2 = g->addTensor({3, 5}, DataType::UInt32);
+    auto op = g->addOp<ConcatObj>(TensorVec{t1, t2}, nullptr, 1);
+    g->dataMalloc();
+    t1->setData(IncrementalGenerator());
+    t2->setData(OneGenerator());
+
+    runtime->run(g);
+    vector<uint32_t> ans;
+    for (uint32_t row = 0; row < 3; ++row) {
+        for (uint32_t col = 0; col < 20000; ++col)
+            ans.emplace_back(row * 20000 + col);
+        ans.insert(ans.end(), 5, 1);
+    }
+    EXPECT_TRUE(op->getOutput()->equalData(ans));
+}
+
 } // namespace infini
@@ -1,6 +1,7 @@
 #include "core/graph.h"
 #include "core/runtime.h"
 #include "operators/element_wise.h"
+#include "utils/half.h"
 
 #include "test.h"
 
@@ -41,4 +42,98 @@ TEST(ElementWise, NativeCpu) {
         Shape{2, 1, 1}, ExpectOutput{0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11});
 }
 
+// Compare Add against a per-element reference for large broadcast patterns
+// that go through the parallel chunking paths.
+void testAddBroadcastNativeCpu(const Shape &shape1, const Shape &shape2) {
+    Runtime runtime = NativeCpuRuntimeObj::getInstance();
+    Graph g = make_ref<GraphObj>(runtime);
+    auto t1 = g->addTensor(shape1, DataType::UInt32);
+    auto t2 = g->addTensor(shape2, DataType::UInt32);
+    auto op = g->addOp<AddObj>(t1, t2, nullptr);
+    g->dataMalloc();
+    t1->setData(IncrementalGenerator());
+    t2->setData(IncrementalGenerator());
+
+    runtime->run(g);
+    auto shapeC = op->getOutput()->getDims();
+    auto rank = shapeC.size();
+    Shape a(rank, 1), b(rank, 1);
+    std::copy(shape1.begin(), shape1.end(), a.end() - shape1.size());
+    std::copy(shape2.begin(), shape2.end(), b.end() - shape2.size());
+    vector<uint32_t> ans(op->getOutput()->size());
+    for (size_t i = 0; i < ans.size(); ++i) {
+        size_t rest = i, ia = 0, ib = 0, sa = 1, sb = 1;
+        for (size_t d = rank; d-- > 0;) {
+            size_t idx = rest % shapeC[d];
+            rest /= shapeC[d];
+            ia += idx % a[d] * sa;
+            ib += idx % b[d] * sb;
+            sa *= a[d];
+            sb *= b[d];
+        }
+        ans[i] = ia + ib;
+    }
+    EXPECT_TRUE(op->getOutput()->equalData(ans));
+}
+
+TEST(ElementWise, NativeCpuBroadcast) {
+    testElementWiseNativeCpu<AddObj>(
+        IncrementalGenerator(), IncrementalGenerator(), Shape{2, 3},
+        Shape{2, 3}, ExpectOutput{0, 2, 4, 6, 8, 10});
+    testElementWiseNativeCpu<AddObj>(
+        IncrementalGenerator(), IncrementalGenerator(), Shape{2, 3}, Shape{3},
+        ExpectOutput{0, 2, 4, 3, 5, 7});
+    testElementWiseNativeCpu<AddObj>(
+        IncrementalGenerator(), IncrementalGenerator(), Shape{2, 3},
+        Shape{2, 1}, ExpectOutput{0, 1, 2, 4, 5, 6});
+    testElementWiseNativeCpu<SubObj>(
+        IncrementalGenerator(), IncrementalGenerator(), Shape{1},
+        Shape{2, 3}, ExpectOutput{0, -1, -2, -3, -4, -5});
+
+    testAddBroadcastNativeCpu({5, 70000}, {5, 70000});
+    testAddBroadcastNativeCpu({100000}, {1});
+    testAddBroadcastNativeCpu({3000, 64}, {64});
+    testAddBroadcastNativeCpu({64, 3000}, {64, 1});
+    testAddBroadcastNativeCpu({4, 1, 300, 5}, {3, 1, 5});
+    testAddBroadcastNativeCpu({7, 1, 9}, {1, 8, 1});
+}
+
+// Float16/BFloat16 are computed in float and rounded once per element.
+void testMulHalfNativeCpu(DataType dtype, const Shape &shape1,
+                          const Shape &shape2) {
+    Runtime runtime = NativeCpuRuntimeObj::getInstance();
+    Graph g = make_ref<GraphObj>(runtime);
+    auto t1 = g->addTensor(shape1, dtype);
+    auto t2 = g->addTensor(shape2, dtype);
+    auto op = g->addOp<MulObj>(t1, t2, nullptr);
+    g->dataMalloc();
+    auto fill = [dtype](void *data, size_t size, DataType) {
+        for (size_t i = 0; i < size; ++i) {
+            float v = float(i % 97) * 0.37f - 11.f;
+            static_cast<uint16_t *>(data)[i] =
+                dtype == DataType::Float16 ? floatToFp16(v) : floatToBf16(v);
+        }
+    };
+    t1->setData(fill);
+    t2->setData(fill);
+
+    runtime->run(g);
+    auto toFloat = [dtype](uint16_t h) {
+        return dtype == DataType::Float16 ? fp16ToFloat(h) : bf16ToFloat(h);
+    };
+    auto a = t1->getRawDataPtr<uint16_t *>(), b = t2->getRawDataPtr<uint16_t *>();
+    auto c = op->getOutput()->getRawDataPtr<uint16_t *>();
+    size_t cols = shape2.back();
+    for (size_t i = 0; i < op->getOutput()->size(); ++i) {
+        float v = toFloat(a[i]) * toFloat(b[i % cols]);
+        ASSERT_EQ(c[i], dtype == DataType::Float16 ? floatToFp16(v)
+                                                   : floatToBf16(v));
+    }
+}
+
+TEST(ElementWise, NativeCpuHalf) {
+    testMulHalfNativeCpu(DataType::Float16, Shape{3, 1000}, Shape{1000});
+    testMulHalfNativeCpu(DataType::BFloat16, Shape{3, 1000}, Shape{1000});
+}
+
 } // namespace infini
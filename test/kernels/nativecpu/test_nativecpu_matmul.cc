@@ -0,0 +1,139 @@
+#include "core/graph.h"
+#include "core/kernel.h"
+#include "core/runtime.h"
+#include "operators/matmul.h"
+#include "utils/half.h"
+
+#include "test.h"
+
+namespace infini {
+
+// Reference triple loop with the same broadcast rules as MatmulObj.
+template <typename T>
+vector<T> naiveMatmul(const Tensor &A, const Tensor &B, const Tensor &C,
+                      bool transA, bool transB) {
+    auto aDims = A->getDims(), bDims = B->getDims(), cDims = C->getDims();
+    int rank = cDims.size();
+    int m = cDims[rank - 2], n = cDims[rank - 1];
+    int k = transA ? aDims[rank - 2] : aDims[rank - 1];
+    auto a = A->getRawDataPtr<T *>(), b = B->getRawDataPtr<T *>();
+    size_t batch = C->size() / (m * n);
+    vector<T> ans(C->size(), 0);
+    for (size_t bi = 0; bi < batch; ++bi) {
+        size_t aOff = 0, bOff = 0, aStep = m * k, bStep = k * n, rest = bi;
+        for (int d = rank - 3; d >= 0; --d) {
+            size_t idx = rest % cDims[d];
+            rest /= cDims[d];
+            aOff += (aDims[d] == 1 ? 0 : idx) * aStep;
+            bOff += (bDims[d] == 1 ? 0 : idx) * bStep;
+            aStep *= aDims[d];
+            bStep *= bDims[d];
+        }
+        for (int i = 0; i < m; ++i)
+            for (int j = 0; j < n; ++j) {
+                T sum = 0;
+                for (int p = 0; p < k; ++p)
+                    sum += a[aOff + (transA ? p * m + i : i * k + p)] *
+                           b[bOff + (transB ? j * k + p : p * n + j)];
+                ans[bi * m * n + i * n + j] = sum;
+            }
+    }
+    return ans;
+}
+
+void testMatmulUInt32(const Shape &shapeA, const Shape &shapeB, bool transA,
+                      bool transB, Kernel *kernel = nullptr) {
+    Runtime runtime = NativeCpuRuntimeObj::getInstance();
+    Graph g = make_ref<GraphObj>(runtime);
+    auto A = g->addTensor(shapeA, DataType::UInt32);
+    auto B = g->addTensor(shapeB, DataType::UInt32);
+    auto op = g->addOp<MatmulObj>(A, B, nullptr, transA, transB);
+    op->setKernel(kernel);
+    g->dataMalloc();
+    A->setData(IncrementalGenerator());
+    B->setData(IncrementalGenerator());
+
+    runtime->run(g);
+    EXPECT_TRUE(op->getOutput()->equalData(
+        naiveMatmul<uint32_t>(A, B, op->getOutput(), transA, transB)));
+}
+
+TEST(Matmul, NativeCpu) {
+    Runtime runtime = NativeCpuRuntimeObj::getInstance();
+    Graph g = make_ref<GraphObj>(runtime);
+    auto A = g->addTensor({1, 2, 3}, DataType::Float32);
+    auto B = g->addTensor({1, 3, 2}, DataType::Float32);
+    auto op = g->addOp<MatmulObj>(A, B, nullptr);
+    g->dataMalloc();
+    A->setData(IncrementalGenerator());
+    B->setData(IncrementalGenerator());
+
+    runtime->run(g);
+    EXPECT_TRUE(op->getOutput()->equalData(vector<float>{10, 13, 28, 40}));
+}
+
+TEST(Matmul, NativeCpuBlocked) {
+    // Exercises edge tiles, several KC blocks and every transpose flag.
+    testMatmulUInt32({1, 67, 300}, {1, 300, 35}, false, false);
+    testMatmulUInt32({1, 300, 67}, {1, 300, 35}, true, false);
+    testMatmulUInt32({1, 67, 300}, {1, 35, 300}, false, true);
+    testMatmulUInt32({1, 300, 67}, {1, 35, 300}, true, true);
+    testMatmulUInt32({1, 1, 513}, {1, 513, 3200}, false, false);
+}
+
+TEST(Matmul, NativeCpuCandidates) {
+    // Every blocking registered for the autotuner must give the same result.
+    const auto &candidates = KernelRegistry::getInstance().getCandidates(
+        KernelAttrs{Device::CPU, OpType::MatMul});
+    EXPECT_GT(candidates.size(), 1u);
+    for (auto &[kernel, name, id] : candidates) {
+        testMatmulUInt32({1, 150, 1100}, {1, 1100, 70}, false, false, kernel);
+        testMatmulUInt32({2, 1100, 13}, {1, 1100, 1030}, true, false, kernel);
+    }
+}
+
+TEST(Matmul, NativeCpuBroadcast) {
+    testMatmulUInt32({2, 1, 7, 9}, {1, 3, 9, 5}, false, false);
+    testMatmulUInt32({2, 3, 9, 7}, {1, 1, 5, 9}, true, true);
+}
+
+TEST(Matmul, NativeCpuHalf) {
+    // Small integers keep every product and sum exact in float, so the
+    // result must match the float reference exactly after rounding.
+    for (auto dtype : {DataType::Float16, DataType::BFloat16}) {
+        Runtime runtime = NativeCpuRuntimeObj::getInstance();
+        Graph g = make_ref<GraphObj>(runtime);
+        auto A = g->addTensor({2, 17, 40}, dtype);
+        auto B = g->addTensor({1, 23, 40}, dtype);
+        auto op = g->addOp<MatmulObj>(A, B, nullptr, false, true);
+        Graph gf = make_ref<GraphObj>(runtime);
+        auto Af = gf->addTensor({2, 17, 40}, DataType::Float32);
+        auto Bf = gf->addTensor({1, 23, 40}, DataType::Float32);
+        auto opf = gf->addOp<MatmulObj>(Af, Bf, nullptr, false, true);
+        g->dataMalloc();
+        gf->dataMalloc();
+        auto fill = [](void *data, size_t size, DataType type) {
+            for (size_t i = 0; i < size; ++i) {
+                float v = float(i % 7) - 3;
+                if (type == DataType::Float32)
+                    static_cast<float *>(data)[i] = v;
+                else
+                    static_cast<uint16_t *>(data)[i] =
+                        type == DataType::Float16 ? floatToFp16(v)
+                                                  : floatToBf16(v);
+            }
+        };
+        A->setData(fill), B->setData(fill), Af->setData(fill), Bf->setData(fill);
+
+        runtime->run(g);
+        runtime->run(gf);
+        auto ref = opf->getOutput()->getRawDataPtr<float *>();
+        vector<uint16_t> ans(opf->getOutput()->size());
+        for (size_t i = 0; i < ans.size(); ++i)
+            ans[i] = dtype == DataType::Float16 ? floatToFp16(ref[i])
+                                                : floatToBf16(ref[i]);
+        EXPECT_TRUE(op->getOutput()->equalData(ans));
+    }
+}
+
+} // namespace infini
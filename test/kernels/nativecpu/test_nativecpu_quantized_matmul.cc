@@ -0,0 +1,77 @@
+#include "core/graph.h"
+#include "core/runtime.h"
+#include "operators/quantized_matmul.h"
+
+#include "test.h"
+
+namespace infini {
+
+// Reference: integer dot products of the zero-point-shifted operands, scaled
+// and rounded the same way as the kernel.
+template <typename TA>
+void testQuantizedMatmul(const Shape &shapeA, int n, bool transB,
+                         const QuantParams &aq, const QuantParams &bq,
+                         const optional<QuantParams> &cq) {
+    Runtime runtime = NativeCpuRuntimeObj::getInstance();
+    Graph g = make_ref<GraphObj>(runtime);
+    const int k = shapeA.back();
+    Tensor A = g->addTensor(shapeA, std::is_signed_v<TA> ? DataType::Int8
+                                                       : DataType::UInt8);
+    Tensor B = g->addTensor(transB ? Shape{n, k} : Shape{k, n}, DataType::Int8);
+    Ref<QuantizedMatmulObj> op = g->addOp<QuantizedMatmulObj>(A, B, nullptr, aq, bq, cq, transB);
+    EXPECT_EQ(op->getOutput()->getDType(),
+              cq ? DataType::Int8 : DataType::Float32);
+    g->dataMalloc();
+    auto a = A->getRawDataPtr<TA *>();
+    auto b = B->getRawDataPtr<int8_t *>();
+    for (size_t i = 0; i < A->size(); ++i)
+        a[i] = TA(i * 37 + 11);
+    for (size_t i = 0; i < B->size(); ++i)
+        b[i] = int8_t(i * 101 + 7);
+
+    runtime->run(g);
+    auto cInt = op->getOutput()->getRawDataPtr<int8_t *>();
+    auto cFloat = op->getOutput()->getRawDataPtr<float *>();
+    const float cScale = cq ? cq->getScale(0) : 1.f;
+    int m = 1;
+    for (size_t i = 0; i + 1 < shapeA.size(); ++i)
+        m *= shapeA[i];
+    for (int i = 0; i < m; ++i)
+        for (int j = 0; j < n; ++j) {
+            int64_t sum = 0;
+            for (int p = 0; p < k; ++p)
+                sum += (int64_t(a[i * k + p]) - aq.getZeroPoint(0)) *
+                       (int64_t(b[transB ? j * k + p : p * n + j]) -
+                        bq.getZeroPoint(j));
+            float real =
+                float(sum) * (aq.getScale(0) * bq.getScale(j) / cScale);
+            if (cq) {
+                float y = std::nearbyint(real) + cq->getZeroPoint(0);
+                ASSERT_EQ(cInt[i * n + j],
+                          int8_t(std::min(127.f, std::max(-128.f, y))));
+            } else
+                ASSERT_FLOAT_EQ(cFloat[i * n + j], real);
+        }
+}
+
+TEST(QuantizedMatmul, NativeCpu) {
+    // per-tensor weights, dequantized output, ragged m, n and k
+    testQuantizedMatmul<int8_t>({2, 7, 45}, 37, false, QuantParams(0.02f, 3),
+                                QuantParams(0.01f, -2), std::nullopt);
+    // per-channel weights stored transposed, requantized output
+    vector<float> scales(20);
+    vector<int> zeros(20);
+    for (int j = 0; j < 20; ++j)
+        scales[j] = 0.001f * (j + 1), zeros[j] = j % 5 - 2;
+    testQuantizedMatmul<int8_t>({9, 130}, 20, true, QuantParams(0.05f, -4),
+                                QuantParams(scales, zeros),
+                                QuantParams(4.f, 6));
+    // unsigned activations
+    testQuantizedMatmul<uint8_t>({5, 64}, 33, false, QuantParams(0.1f, 128),
+                                 QuantParams(scales[3], 0), std::nullopt);
+    // empty k: the output holds just the zero point
+    testQuantizedMatmul<int8_t>({3, 0}, 5, false, QuantParams(0.02f, 3),
+                                QuantParams(0.01f, -2), QuantParams(4.f, 6));
+}
+
+} // namespace infini
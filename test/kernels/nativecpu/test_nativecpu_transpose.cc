@@ -7,6 +7,41 @@
 
 namespace infini {
 
+// Moves every element to its permuted position one at a time.
+vector<uint32_t> naiveTranspose(const Shape &inDim, const Shape &permute) {
+    size_t rank = inDim.size(), size = 1;
+    for (auto d : inDim)
+        size *= d;
+    Shape outDim(rank);
+    for (size_t j = 0; j < rank; ++j)
+        outDim[j] = inDim[permute[j]];
+    vector<uint32_t> ans(size);
+    for (size_t inIdx = 0; inIdx < size; ++inIdx) {
+        Shape pos(rank);
+        for (size_t i = rank, rest = inIdx; i-- > 0;) {
+            pos[i] = rest % inDim[i];
+            rest /= inDim[i];
+        }
+        size_t outIdx = 0;
+        for (size_t j = 0; j < rank; ++j)
+            outIdx = outIdx * outDim[j] + pos[permute[j]];
+        ans[outIdx] = inIdx;
+    }
+    return ans;
+}
+
+void testTransposeUInt32(const Shape &inDim, const Shape &permute) {
+    Runtime runtime = NativeCpuRuntimeObj::getInstance();
+    Graph g = make_ref<GraphObj>(runtime);
+    auto input = g->addTensor(inDim, DataType::UInt32);
+    auto op = g->addOp<TransposeObj>(input, nullptr, permute);
+    g->dataMalloc();
+    input->setData(IncrementalGenerator());
+
+    runtime->run(g);
+    EXPECT_TRUE(op->getOutput(0)->equalData(naiveTranspose(inDim, permute)));
+}
+
 TEST(Transpose, NativeCpu) {
     Runtime runtime = NativeCpuRuntimeObj::getInstance();
     Graph g = make_ref<GraphObj>(runtime);
@@ -24,4 +59,58 @@ TEST(Transpose, NativeCpu) {
                                                           8, 9, 10, 11, 20, 21, 22, 23}));
 }
 
+TEST(Transpose, NativeCpuTiled) {
+    // 2D tiles with ragged edges on both sides of the 8x8 blocks
+    testTransposeUInt32({67, 45}, {1, 0});
+    testTransposeUInt32({3, 5, 19, 40}, {0, 1, 3, 2});
+    // contiguous inner runs, and merged dimensions
+    testTransposeUInt32({2, 12, 33, 16}, {0, 2, 1, 3});
+    testTransposeUInt32({4, 1, 6, 7, 9}, {2, 3, 1, 0, 4});
+    testTransposeUInt32({5, 6, 7}, {2, 0, 1});
+    testTransposeUInt32({5, 6, 7}, {1, 2, 0});
+    testTransposeUInt32({8, 9}, {0, 1});
+}
+
+void testTransposeHalf(DataType dtype, const Shape &inDim,
+                       const Shape &permute) {
+    Runtime runtime = NativeCpuRuntimeObj::getInstance();
+    Graph g = make_ref<GraphObj>(runtime);
+    auto input = g->addTensor(inDim, dtype);
+    auto op = g->addOp<TransposeObj>(input, nullptr, permute);
+    g->dataMalloc();
+    input->setData([](void *data, size_t size, DataType) {
+        for (size_t i = 0; i < size; ++i)
+            static_cast<uint16_t *>(data)[i] = i;
+    });
+
+    runtime->run(g);
+    auto ans = naiveTranspose(inDim, permute);
+    EXPECT_TRUE(op->getOutput()->equalData(vector<uint16_t>(ans.begin(), ans.end())));
+}
+
+TEST(Transpose, NativeCpuHalf) {
+    // 16-bit types move as raw bits through 8x8 register tiles.
+    testTransposeHalf(DataType::Float16, {5, 37, 19}, {0, 2, 1});
+    testTransposeHalf(DataType::Float16, {64, 40}, {1, 0});
+    testTransposeHalf(DataType::BFloat16, {2, 12, 33, 16}, {0, 2, 1, 3});
+    testTransposeHalf(DataType::BFloat16, {3, 24, 17}, {2, 0, 1});
+    // other 2-byte types take the generic kernel
+    testTransposeHalf(DataType::UInt16, {5, 37, 19}, {0, 2, 1});
+}
+
+TEST(Transpose, TypedKernelDispatch) {
+    auto kernelName = [](DataType dtype) {
+        return std::get<1>(KernelRegistry::getInstance().getKernelItem(
+            KernelAttrs{Device::CPU, OpType::Transpose, dtype}));
+    };
+    EXPECT_EQ(kernelName(DataType::Float16), "TransposeHalf_CPU");
+    EXPECT_EQ(kernelName(DataType::BFloat16), "TransposeHalf_CPU");
+    // types without a kernel of their own fall back to the untyped one
+    EXPECT_EQ(kernelName(DataType::Float32), "TransposeNaive_CPU");
+    EXPECT_EQ(kernelName(DataType::UInt16), "TransposeNaive_CPU");
+    EXPECT_THROW(KernelRegistry::getInstance().getKernel(
+                     KernelAttrs{Device::CPU, OpType::Unknown}),
+                 Exception);
+}
+
 } // namespace infini
@@ -0,0 +1,87 @@
+#include "core/graph.h"
+#include "core/runtime.h"
+#include "operators/unary.h"
+#include "utils/half.h"
+
+#include "test.h"
+
+namespace infini {
+
+TEST(Relu, NativeCpu) {
+    Runtime runtime = NativeCpuRuntimeObj::getInstance();
+    Graph g = make_ref<GraphObj>(runtime);
+    auto input = g->addTensor({3, 7}, DataType::Float32);
+    auto op = g->addOp<ReluObj>(input, nullptr);
+    g->dataMalloc();
+    input->setData([](void *data, size_t size, DataType) {
+        for (size_t i = 0; i < size; ++i)
+            static_cast<float *>(data)[i] = float(i) - 10;
+    });
+
+    runtime->run(g);
+    vector<float> ans(21);
+    for (size_t i = 0; i < ans.size(); ++i)
+        ans[i] = std::max(0.f, float(i) - 10);
+    EXPECT_TRUE(op->getOutput()->equalData(ans));
+}
+
+TEST(Clip, NativeCpu) {
+    Runtime runtime = NativeCpuRuntimeObj::getInstance();
+    {
+        Graph g = make_ref<GraphObj>(runtime);
+        auto input = g->addTensor({3, 7}, DataType::Float32);
+        auto op = g->addOp<ClipObj>(input, nullptr, 3.5f, 15.f);
+        g->dataMalloc();
+        input->setData(IncrementalGenerator());
+
+        runtime->run(g);
+        vector<float> ans(21);
+        for (size_t i = 0; i < ans.size(); ++i)
+            ans[i] = std::min(15.f, std::max(3.5f, float(i)));
+        EXPECT_TRUE(op->getOutput()->equalData(ans));
+    }
+    {
+        Graph g = make_ref<GraphObj>(runtime);
+        auto input = g->addTensor({19}, DataType::UInt32);
+        auto op = g->addOp<ClipObj>(input, nullptr, std::nullopt, 9.f);
+        g->dataMalloc();
+        input->setData(IncrementalGenerator());
+
+        runtime->run(g);
+        vector<uint32_t> ans(19);
+        for (size_t i = 0; i < ans.size(); ++i)
+            ans[i] = std::min<uint32_t>(9, i);
+        EXPECT_TRUE(op->getOutput()->equalData(ans));
+    }
+}
+
+TEST(Relu, NativeCpuHalf) {
+    Runtime runtime = NativeCpuRuntimeObj::getInstance();
+    for (auto dtype : {DataType::Float16, DataType::BFloat16}) {
+        Graph g = make_ref<GraphObj>(runtime);
+        auto input = g->addTensor({3, 300}, dtype);
+        auto op = g->addOp<ReluObj>(input, nullptr);
+        auto clip = g->addOp<ClipObj>(input, nullptr, -2.5f, 3.f);
+        g->dataMalloc();
+        auto fromFloat = [dtype](float v) {
+            return dtype == DataType::Float16 ? floatToFp16(v)
+                                              : floatToBf16(v);
+        };
+        input->setData([&](void *data, size_t size, DataType) {
+            for (size_t i = 0; i < size; ++i)
+                static_cast<uint16_t *>(data)[i] = fromFloat(float(i) / 64 - 7);
+        });
+
+        runtime->run(g);
+        vector<uint16_t> relu(900), clipped(900);
+        for (size_t i = 0; i < relu.size(); ++i) {
+            relu[i] = fromFloat(std::max(0.f, float(i) / 64 - 7));
+            clipped[i] =
+                fromFloat(std::min(3.f, std::max(-2.5f, float(i) / 64 - 7)));
+        }
+        EXPECT_TRUE(op->getOutput()->equalData(relu));
+        EXPECT_TRUE(clip->getOutput()->equalData(clipped));
+    }
+}
+
+} // namespace infini
@@ -0,0 +1,80 @@
+#include "core/data_type.h"
+#include "utils/half.h"
+#include "utils/vectorized.h"
+
+#include "test.h"
+
+namespace infini {
+
+// Every instruction set the host supports must match the scalar result,
+// including the tails that do not fill a whole vector.
+TEST(Vectorized, MatchesScalar) {
+    const size_t n = 67;
+    vector<float> a(n), b(n), c(n);
+    vector<uint32_t> ua(n), ub(n), uc(n);
+    for (size_t i = 0; i < n; ++i) {
+        a[i] = float(i) - 30.5f, b[i] = float(i % 7) + 0.25f;
+        ua[i] = i * 2654435761u, ub[i] = i + 3;
+    }
+    for (auto isa : {CpuIsa::SSE41, CpuIsa::AVX2, CpuIsa::AVX512}) {
+        if (isa > getCpuIsa())
+            continue;
+        const auto &kernels = getVectorKernels(isa);
+        EXPECT_EQ(kernels.isa, isa);
+        for (size_t sa : {0, 1})
+            for (size_t sb : {0, 1}) {
+                kernels.binaryF32[(int)VecBinary::Sub](a.data(), sa, b.data(),
+                                                       sb, c.data(), n);
+                kernels.binaryU32[(int)VecBinary::Mul](
+                    ua.data(), sa, ub.data(), sb, uc.data(), n);
+                for (size_t i = 0; i < n; ++i) {
+                    EXPECT_EQ(c[i], a[i * sa] - b[i * sb]);
+                    EXPECT_EQ(uc[i], ua[i * sa] * ub[i * sb]);
+                }
+            }
+        kernels.binaryF32[(int)VecBinary::Div](a.data(), 1, b.data(), 1,
+                                               c.data(), n);
+        for (size_t i = 0; i < n; ++i)
+            EXPECT_EQ(c[i], a[i] / b[i]);
+        kernels.reluF32(a.data(), c.data(), n);
+        for (size_t i = 0; i < n; ++i)
+            EXPECT_EQ(c[i], std::max(0.f, a[i]));
+        kernels.clipF32(a.data(), c.data(), n, -3.f, 4.5f);
+        for (size_t i = 0; i < n; ++i)
+            EXPECT_EQ(c[i], std::min(4.5f, std::max(-3.f, a[i])));
+        EXPECT_EQ(kernels.binaryU32[(int)VecBinary::Div], nullptr);
+    }
+}
+
+// The 16-bit float conversions must agree bit for bit with utils/half.h:
+// every half and bfloat16 value, and floats spread over the whole range.
+TEST(Vectorized, HalfConversions) {
+    vector<uint16_t> h(1 << 16), h2(1 << 16);
+    vector<float> f(1 << 16);
+    for (size_t i = 0; i < h.size(); ++i)
+        h[i] = i;
+    vector<float> fs;
+    for (uint64_t bits = 0; bits < (1ull << 32); bits += 0x1357)
+        fs.emplace_back(bitsToFloat(bits));
+    vector<uint16_t> hs(fs.size());
+    for (auto isa : {CpuIsa::SSE41, CpuIsa::AVX2, CpuIsa::AVX512}) {
+        if (isa > getCpuIsa())
+            continue;
+        const auto &kernels = getVectorKernels(isa);
+        // DataType::Float16 is 10, BFloat16 16 and Float32 1
+        kernels.cast[10][1](h.data(), f.data(), h.size());
+        for (size_t i = 0; i < h.size(); ++i)
+            EXPECT_EQ(floatBits(f[i]), floatBits(fp16ToFloat(h[i])));
+        kernels.cast[16][1](h.data(), f.data(), h.size());
+        for (size_t i = 0; i < h.size(); ++i)
+            EXPECT_EQ(floatBits(f[i]), floatBits(bf16ToFloat(h[i])));
+        kernels.cast[1][10](fs.data(), hs.data(), fs.size());
+        for (size_t i = 0; i < fs.size(); ++i)
+            ASSERT_EQ(hs[i], floatToFp16(fs[i])) << fs[i];
+        kernels.cast[1][16](fs.data(), hs.data(), fs.size());
+        for (size_t i = 0; i < fs.size(); ++i)
+            ASSERT_EQ(hs[i], floatToBf16(fs[i])) << fs[i];
+    }
+}
+
+} // namespace infini